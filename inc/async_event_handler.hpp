@@ -0,0 +1,230 @@
+/**
+ * @file	async_event_handler.hpp
+ * @brief	Implements an event handler whose events are queued and handled on a dispatcher thread.
+ * @author	Kacper Kowalski - kacper.s.kowalski@gmail.com
+ */
+
+#ifndef ASYNC_EVENT_HANDLER_HPP
+#define ASYNC_EVENT_HANDLER_HPP
+
+#include "concurrent_event_handler.hpp"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+
+namespace jungles {
+
+// --------------------------------------------------------------------------------------------------------------------
+// DECLARATIONS FOR PUBLIC USE
+// --------------------------------------------------------------------------------------------------------------------
+
+template <typename Signature, std::size_t Capacity, bool IsCoalescing = false> class async_event_handler;
+
+/**
+ * \brief       An event handler which moves the invocation of the handlers out of the context which raises the event.
+ *
+ * post() copies the arguments of the event into a bounded lock-free ring and returns. A dispatcher thread, owned by
+ * the object, drains the ring in batches and invokes the handlers with each of the events, in the order of posting.
+ * Posting an event costs a slot reservation with a compare-and-swap and a single load of the flag telling whether the
+ * dispatcher sleeps. post() never takes a lock: a sleeping dispatcher is notified without locking its mutex. Such a
+ * notification may come just before the dispatcher starts waiting and get lost, so the dispatcher never sleeps longer
+ * than max_sleep_time, which bounds the latency of the event in that rare case.
+ *
+ * With IsCoalescing set, an event equal (operator==) to the event posted right after it is dropped by the dispatcher,
+ * so a burst of the same events invokes the handlers once, with the last of the events.
+ *
+ * The handlers are kept in a concurrent_event_handler, so they can be registered from any thread. They are invoked
+ * only from the dispatcher thread. The destructor handles all the posted events before joining the dispatcher.
+ *
+ * async_event_handler<void(unsigned), 64> eh;
+ *
+ * \tparam Signature    void(Args...), where the Args are the types of the payload. They are stored by value.
+ * \tparam Capacity     The maximum number of the events waiting for the dispatcher. Must be a power of two.
+ * \tparam IsCoalescing Whether to drop an event equal to the next one.
+ */
+template <typename... Args, std::size_t Capacity, bool IsCoalescing>
+class async_event_handler<void(Args...), Capacity, IsCoalescing>
+{
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+    static_assert(!(std::is_reference_v<Args> || ...), "The payload is copied, so it can't hold references");
+
+  public:
+    using handlers_type = concurrent_event_handler<Args...>;
+    using policy = typename handlers_type::policy;
+    using handler_type = typename handlers_type::handler_type;
+
+    async_event_handler();
+    ~async_event_handler();
+
+    async_event_handler(const async_event_handler &) = delete;
+    async_event_handler &operator=(const async_event_handler &) = delete;
+
+    //! Thread-safe. Returns false, and drops the event, when the ring is full.
+    template <typename... Ts> bool post(Ts &&...args);
+
+    //! Thread-safe.
+    void register_handler(handler_type handler);
+
+  private:
+    using event = std::tuple<Args...>;
+
+    //! Vyukov's bounded queue cell: the sequence tells whether the cell awaits a producer or the consumer.
+    struct cell
+    {
+        std::atomic<std::size_t> sequence;
+        std::optional<event> payload;
+    };
+
+    std::array<cell, Capacity> m_cells;
+    alignas(64) std::atomic<std::size_t> m_enqueue_pos{0};
+    alignas(64) std::size_t m_dequeue_pos{0};
+
+    handlers_type m_handlers;
+
+    std::mutex m_sleep_mutex;
+    std::condition_variable m_wake_up;
+    std::atomic<bool> m_is_sleeping{false};
+    bool m_is_stopping{false};
+
+    std::thread m_dispatcher;
+
+    //! The dispatcher checks the ring at least that often, in case a notification from post() has been lost.
+    static constexpr std::chrono::milliseconds max_sleep_time{10};
+
+    void run();
+
+    //! Handles at most Capacity events. Returns the number of the events taken from the ring.
+    std::size_t dispatch_batch();
+
+    cell *ready_cell(std::size_t pos);
+};
+
+// --------------------------------------------------------------------------------------------------------------------
+// DEFINITIONS OF PUBLIC STUFF
+// --------------------------------------------------------------------------------------------------------------------
+template <typename... Args, std::size_t Capacity, bool IsCoalescing>
+async_event_handler<void(Args...), Capacity, IsCoalescing>::async_event_handler()
+{
+    for (std::size_t i = 0; i < Capacity; ++i)
+        m_cells[i].sequence.store(i, std::memory_order_relaxed);
+    m_dispatcher = std::thread{[this]() { run(); }};
+}
+
+template <typename... Args, std::size_t Capacity, bool IsCoalescing>
+async_event_handler<void(Args...), Capacity, IsCoalescing>::~async_event_handler()
+{
+    {
+        std::lock_guard<std::mutex> lock{m_sleep_mutex};
+        m_is_stopping = true;
+    }
+    m_wake_up.notify_one();
+    m_dispatcher.join();
+}
+
+template <typename... Args, std::size_t Capacity, bool IsCoalescing>
+template <typename... Ts>
+bool async_event_handler<void(Args...), Capacity, IsCoalescing>::post(Ts &&...args)
+{
+    static_assert(sizeof...(Ts) == sizeof...(Args), "post() must be given one argument for each of the Args");
+
+    auto pos{m_enqueue_pos.load(std::memory_order_relaxed)};
+    cell *c;
+    while (true)
+    {
+        c = &m_cells[pos & (Capacity - 1)];
+        auto seq{c->sequence.load(std::memory_order_acquire)};
+        auto diff{static_cast<std::intptr_t>(seq) - static_cast<std::intptr_t>(pos)};
+        if (diff == 0)
+        {
+            if (m_enqueue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                break;
+        }
+        else if (diff < 0)
+            return false;
+        else
+            pos = m_enqueue_pos.load(std::memory_order_relaxed);
+    }
+    c->payload.emplace(std::forward<Ts>(args)...);
+    c->sequence.store(pos + 1, std::memory_order_release);
+
+    // Pairs with the fence in run(): either the dispatcher sees the event or this sees the dispatcher sleeping.
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (m_is_sleeping.load(std::memory_order_relaxed))
+        m_wake_up.notify_one();
+    return true;
+}
+
+template <typename... Args, std::size_t Capacity, bool IsCoalescing>
+void async_event_handler<void(Args...), Capacity, IsCoalescing>::register_handler(handler_type handler)
+{
+    m_handlers.register_handler(std::move(handler));
+}
+
+// --------------------------------------------------------------------------------------------------------------------
+// DEFINITIONS OF PRIVATE STUFF
+// --------------------------------------------------------------------------------------------------------------------
+template <typename... Args, std::size_t Capacity, bool IsCoalescing>
+void async_event_handler<void(Args...), Capacity, IsCoalescing>::run()
+{
+    while (true)
+    {
+        if (dispatch_batch() != 0)
+            continue;
+
+        std::unique_lock<std::mutex> lock{m_sleep_mutex};
+        m_is_sleeping.store(true, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        m_wake_up.wait_for(
+            lock, max_sleep_time, [this]() { return ready_cell(m_dequeue_pos) != nullptr || m_is_stopping; });
+        m_is_sleeping.store(false, std::memory_order_relaxed);
+        if (m_is_stopping && ready_cell(m_dequeue_pos) == nullptr)
+            return;
+    }
+}
+
+template <typename... Args, std::size_t Capacity, bool IsCoalescing>
+std::size_t async_event_handler<void(Args...), Capacity, IsCoalescing>::dispatch_batch()
+{
+    std::size_t num_taken{0};
+    for (; num_taken < Capacity; ++num_taken)
+    {
+        auto c{ready_cell(m_dequeue_pos)};
+        if (c == nullptr)
+            break;
+
+        bool is_coalesced{false};
+        if constexpr (IsCoalescing)
+        {
+            auto next{ready_cell(m_dequeue_pos + 1)};
+            is_coalesced = next != nullptr && *next->payload == *c->payload;
+        }
+        if (!is_coalesced)
+            std::apply([this](auto &...payload) { m_handlers.raise(payload...); }, *c->payload);
+
+        c->payload.reset();
+        c->sequence.store(m_dequeue_pos + Capacity, std::memory_order_release);
+        ++m_dequeue_pos;
+    }
+    return num_taken;
+}
+
+template <typename... Args, std::size_t Capacity, bool IsCoalescing>
+typename async_event_handler<void(Args...), Capacity, IsCoalescing>::cell *
+async_event_handler<void(Args...), Capacity, IsCoalescing>::ready_cell(std::size_t pos)
+{
+    auto &c{m_cells[pos & (Capacity - 1)]};
+    return c.sequence.load(std::memory_order_acquire) == pos + 1 ? &c : nullptr;
+}
+
+} // namespace jungles
+
+#endif /* ASYNC_EVENT_HANDLER_HPP */
@@ -9,23 +9,47 @@
 
 #include "utils.hpp"
 #include <cinttypes>
+#include <cstring>
+
+#if __has_include(<bit>)
+#include <bit>
+#endif
 
 namespace jungles {
 
 namespace detail {
 
-//! This is dangerous and can only be used internally unless you know what you are doing.
-template <typename T, typename It> void write_and_advance(It &it, T val)
+/**
+ * Returns the object representation of the value as an array of bytes, in native endianness. Uses std::bit_cast (or
+ * the compiler builtin it is implemented with) so it can be evaluated at compile time. When none of them is available
+ * it falls back to std::memcpy, which limits the binary_stream to run time use only.
+ */
+template <typename T> constexpr std::array<uint8_t, sizeof(T)> to_bytes(T val)
 {
-    auto to_ptr = &(*it);
-    auto to_byte_ptr = reinterpret_cast<uint8_t *>(to_ptr);
-
-    auto from_ptr = &val;
-    auto from_byte_ptr = reinterpret_cast<uint8_t *>(from_ptr);
+#if defined(__cpp_lib_bit_cast)
+    return std::bit_cast<std::array<uint8_t, sizeof(T)>>(val);
+#elif defined(__has_builtin)
+#if __has_builtin(__builtin_bit_cast)
+    return __builtin_bit_cast(std::array<uint8_t, sizeof(T)>, val);
+#else
+    std::array<uint8_t, sizeof(T)> bytes{};
+    std::memcpy(bytes.data(), &val, sizeof(T));
+    return bytes;
+#endif
+#else
+    std::array<uint8_t, sizeof(T)> bytes{};
+    std::memcpy(bytes.data(), &val, sizeof(T));
+    return bytes;
+#endif
+}
 
-    std::copy(from_byte_ptr, from_byte_ptr + sizeof(T), to_byte_ptr);
-    using IterableType = typename std::iterator_traits<It>::value_type;
-    std::advance(it, sizeof(T) / sizeof(IterableType));
+//! Writes the bytes of val to the buffer under the specified offset and advances the offset.
+template <typename T, std::size_t N>
+constexpr void write_and_advance(std::array<uint8_t, N> &buf, std::size_t &off, T val)
+{
+    auto bytes{to_bytes(val)};
+    for (std::size_t i = 0; i < sizeof(T); ++i)
+        buf[off++] = bytes[i];
 }
 
 } // namespace detail
@@ -38,6 +62,9 @@ template <typename T, typename It> void write_and_advance(It &it, T val)
  * internal buffer. This class uses native endianness.
  * Streaming a uint16_t variable of value 0xFFEE to an empty stream will result in putting 0xEE under index 0 of the
  * internal buffer and putting 0xFF under index 1 of the internal buffer.
+ *
+ * The stream can be used in constexpr context, so fixed frames can be built at compile time and placed in read-only
+ * memory. Use make_binary_stream() for that and send such frames with data() and size().
  */
 template <std::size_t InternalBufSize> class binary_stream
 {
@@ -54,47 +81,72 @@ template <std::size_t InternalBufSize> class binary_stream
      * \returns true when all of the params were put to the stream, false if none of the params have been put.
      * \note If there is no place for all parameters to be but then no parameter is put to the stream.
      */
-    template <typename... TrivialTypes> bool write(TrivialTypes... params)
+    template <typename... TrivialTypes> constexpr bool write(TrivialTypes... params)
     {
         constexpr unsigned sizeof_params = (sizeof(params) + ... + 0);
         static_assert(jungles::utils::all_trivial<TrivialTypes...>::value, "The parameters must be trivial types");
         if (space_left() < sizeof_params)
             return false;
 
-        (jungles::detail::write_and_advance(m_it, params), ...);
+        (jungles::detail::write_and_advance(m_buf, m_size, params), ...);
         return true;
     }
 
     //! Clears the stream and removes all the data from it.
-    void clear()
+    constexpr void clear()
     {
-        m_it = std::begin(m_buf);
+        m_size = 0;
     }
 
     //! Returns begin iterator to the stream. Never invalidated.
-    BinaryStreamConstIterator cbegin() const
+    constexpr BinaryStreamConstIterator cbegin() const
     {
         return std::cbegin(m_buf);
     }
 
     //! Returns end iterator to the stream. Gets invalidated after call to write() or clear().
-    BinaryStreamConstIterator cend() const
+    constexpr BinaryStreamConstIterator cend() const
     {
-        return static_cast<BinaryStreamConstIterator>(m_it);
+        return std::next(std::cbegin(m_buf), m_size);
     }
 
-  private:
-    using BinaryStreamIterator = typename ByteArrayType::iterator;
+    //! Returns pointer to the streamed data. Never invalidated.
+    constexpr const Byte *data() const
+    {
+        return m_buf.data();
+    }
 
-    ByteArrayType m_buf;
-    BinaryStreamIterator m_it{std::begin(m_buf)};
+    //! Returns number of bytes streamed so far.
+    constexpr std::size_t size() const
+    {
+        return m_size;
+    }
+
+  private:
+    ByteArrayType m_buf{};
+    std::size_t m_size{0};
 
-    unsigned space_left() const
+    constexpr std::size_t space_left() const
     {
-        return std::distance(static_cast<BinaryStreamConstIterator>(m_it), std::end(m_buf));
+        return InternalBufSize - m_size;
     }
 };
 
+/**
+ * \brief Creates a binary_stream which is just big enough to hold all the params and writes them to it.
+ *
+ * Intended to build constant frames at compile time:
+ *
+ * static constexpr auto frame{jungles::make_binary_stream(uint8_t{0xAA}, uint16_t{0x0102})};
+ * send(frame.data(), frame.size());
+ */
+template <typename... TrivialTypes> constexpr auto make_binary_stream(TrivialTypes... params)
+{
+    binary_stream<(sizeof(params) + ... + 0)> bs;
+    bs.write(params...);
+    return bs;
+}
+
 } // namespace jungles
 
 #endif /* BINARY_STREAM_HPP */
@@ -8,11 +8,69 @@
 #define BOUNDARY_MAPPER_HPP
 
 #include <array>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <type_traits>
+#include <utility>
+
+/**
+ * The maximum size in bytes of the lookup table, which boundary_mapper generates to convert integers in one load, when
+ * the search strategy is selected automatically. Define it globally to change the budget; 0 disables the tables.
+ */
+#ifndef JUNGLES_BOUNDARY_MAPPER_LOOKUP_TABLE_MAX_BYTES
+#define JUNGLES_BOUNDARY_MAPPER_LOOKUP_TABLE_MAX_BYTES 4096
+#endif
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
 
 namespace jungles {
 
+/**
+ * \brief Specifies how boundary_mapper searches for the interval to which a value belongs.
+ *
+ * By default the strategy is selected at compile time from the value type and the boundaries, see
+ * detail::default_search_strategy().
+ */
+enum class boundary_search_strategy
+{
+    //! Compares the value with each boundary. Fastest for a few boundaries.
+    linear,
+
+    //! Branchless binary search over the sorted boundaries.
+    binary,
+
+    //! Branchless search over the boundaries reordered to the cache friendly Eytzinger layout. Best for large sets.
+    eytzinger,
+
+    /**
+     * A table which maps each integer between the lowest and the highest boundary to its interval. The values are
+     * clamped to the table range, so convert() is a single load. Only for integral values.
+     */
+    lookup_table
+};
+
 namespace detail {
 
+/**
+ * Selects the search strategy of boundary_mapper, which doesn't use a lookup table, depending on the number of
+ * boundaries. The thresholds come from the benchmark in test_boundary_mapper.cpp: the Eytzinger layout pays off only
+ * when the boundaries don't fit in L1 cache.
+ */
+constexpr boundary_search_strategy default_search_strategy(std::size_t num_boundaries)
+{
+    if (num_boundaries <= 8)
+        return boundary_search_strategy::linear;
+    else if (num_boundaries < 1024)
+        return boundary_search_strategy::binary;
+    else
+        return boundary_search_strategy::eytzinger;
+}
+
 //! This is taken from std documentation, only 'constexpr' keyword has been added.
 template <class ForwardIt, class Compare>
 constexpr ForwardIt is_sorted_until_impl(ForwardIt first, ForwardIt last, Compare comp)
@@ -39,6 +97,327 @@ template <class ForwardIt> constexpr bool is_ascending(ForwardIt first, ForwardI
     return is_sorted_until_impl(first, last, std::less_equal<>()) == last;
 }
 
+//! Counts the trailing set bits. Used to step back from a leaf of the Eytzinger tree.
+constexpr unsigned count_trailing_ones(std::size_t v)
+{
+#if defined(__GNUC__)
+    return static_cast<unsigned>(__builtin_ctzll(~static_cast<unsigned long long>(v)));
+#else
+    unsigned res = 0;
+    for (; v & 1; v >>= 1)
+        ++res;
+    return res;
+#endif
+}
+
+//! Returns the number of boundaries lower than val by comparing val against each of them, without branching.
+template <typename T, std::size_t N, std::size_t... Is>
+constexpr std::size_t linear_lower_bound(const std::array<T, N> &boundaries, T val, std::index_sequence<Is...>)
+{
+    return (static_cast<std::size_t>(boundaries[Is] < val) + ... + 0);
+}
+
+/**
+ * Returns the index of the first element in the sorted range <first, first + n) which is not less than val, or n when
+ * there is no such element. The loop has a fixed number of iterations for given n and the only conditional is a
+ * conditional move, so the search doesn't suffer from branch mispredictions.
+ */
+template <typename T> constexpr std::size_t branchless_lower_bound(const T *first, std::size_t n, T val)
+{
+    if (n == 0)
+        return 0;
+
+    const T *base = first;
+    while (n > 1)
+    {
+        auto half = n / 2;
+        base = (base[half] < val) ? base + half : base;
+        n -= half;
+    }
+    return static_cast<std::size_t>(base - first) + static_cast<std::size_t>(*base < val);
+}
+
+/**
+ * The boundaries reordered in the breadth-first order of an implicit binary search tree (Eytzinger layout). The
+ * element under the index k has its children under 2k and 2k + 1, index 0 is unused. The consecutive levels of the
+ * tree lie next to each other in memory, thus the search makes good use of the cache. The ranks hold the original
+ * (sorted) index of each element.
+ */
+template <typename T, std::size_t N> struct eytzinger_layout
+{
+    std::array<T, N + 1> values{};
+    std::array<std::size_t, N + 1> ranks{};
+};
+
+/**
+ * Puts the sorted elements <sorted, sorted + n) in the Eytzinger order to values, and their original indexes to ranks.
+ * Both values and ranks must have n + 1 elements.
+ */
+template <typename T>
+constexpr std::size_t fill_eytzinger_layout(
+    const T *sorted, std::size_t n, T *values, std::size_t *ranks, std::size_t i = 0, std::size_t k = 1)
+{
+    if (k <= n)
+    {
+        i = fill_eytzinger_layout(sorted, n, values, ranks, i, 2 * k);
+        values[k] = sorted[i];
+        ranks[k] = i;
+        ++i;
+        i = fill_eytzinger_layout(sorted, n, values, ranks, i, 2 * k + 1);
+    }
+    return i;
+}
+
+template <typename T, std::size_t N>
+constexpr eytzinger_layout<T, N> make_eytzinger_layout(const std::array<T, N> &sorted)
+{
+    eytzinger_layout<T, N> layout{};
+    fill_eytzinger_layout(sorted.data(), N, layout.values.data(), layout.ranks.data());
+    return layout;
+}
+
+//! The same as branchless_lower_bound() but for the boundaries stored in the Eytzinger layout.
+template <typename T>
+constexpr std::size_t eytzinger_lower_bound(const T *values, const std::size_t *ranks, std::size_t n, T val)
+{
+    std::size_t k = 1;
+    while (k <= n)
+        k = 2 * k + static_cast<std::size_t>(values[k] < val);
+    k >>= count_trailing_ones(k) + 1;
+    return k == 0 ? n : ranks[k];
+}
+
+//! The layout is computed at compile time only for the mappers which use it.
+template <typename T, std::size_t N, const std::array<T, N> &Boundaries>
+inline constexpr eytzinger_layout<T, N> eytzinger_layout_of{make_eytzinger_layout(Boundaries)};
+
+//! The smallest unsigned type which can hold the interval index, to keep the lookup table small.
+template <std::size_t N>
+using lookup_table_entry_t = std::conditional_t<N <= std::numeric_limits<uint8_t>::max(),
+                                                uint8_t,
+                                                std::conditional_t<N <= std::numeric_limits<uint16_t>::max(),
+                                                                   uint16_t,
+                                                                   std::size_t>>;
+
+//! Returns the offset of val from the lowest boundary, using modular arithmetic so it works for signed types too.
+template <typename T> constexpr unsigned long long offset_from(T lowest, T val)
+{
+    return static_cast<unsigned long long>(val) - static_cast<unsigned long long>(lowest);
+}
+
+/**
+ * Returns the number of entries in the lookup table for the boundaries: one per each integer from the lowest to the
+ * highest boundary and one more for the values above the highest boundary.
+ */
+template <typename T, std::size_t N> constexpr unsigned long long lookup_table_size(const std::array<T, N> &boundaries)
+{
+    return offset_from(boundaries.front(), boundaries.back()) + 2;
+}
+
+template <typename T, std::size_t N> constexpr bool fits_lookup_table_budget(const std::array<T, N> &boundaries)
+{
+    if constexpr (!std::is_integral_v<T>)
+        return false;
+    else
+    {
+        constexpr unsigned long long max_entries{JUNGLES_BOUNDARY_MAPPER_LOOKUP_TABLE_MAX_BYTES /
+                                                 sizeof(lookup_table_entry_t<N>)};
+        // Compare the offset first, as the size may overflow for the widest types.
+        return offset_from(boundaries.front(), boundaries.back()) < max_entries &&
+               lookup_table_size(boundaries) <= max_entries;
+    }
+}
+
+template <typename T, std::size_t N, std::size_t TableSize>
+constexpr std::array<lookup_table_entry_t<N>, TableSize> make_lookup_table(const std::array<T, N> &boundaries)
+{
+    std::array<lookup_table_entry_t<N>, TableSize> table{};
+    std::size_t interval = 0;
+    for (std::size_t i = 0; i < TableSize; ++i)
+    {
+        // The entry i corresponds to the value boundaries.front() + i.
+        while (interval < N && offset_from(boundaries.front(), boundaries[interval]) < i)
+            ++interval;
+        table[i] = static_cast<lookup_table_entry_t<N>>(interval);
+    }
+    return table;
+}
+
+//! The table is computed at compile time only for the mappers which use it.
+template <typename T, std::size_t N, const std::array<T, N> &Boundaries>
+inline constexpr auto lookup_table_of{
+    make_lookup_table<T, N, static_cast<std::size_t>(lookup_table_size(Boundaries))>(Boundaries)};
+
+//! Maps the value to the index of the lookup table entry, clamping it to the table range without branching.
+template <typename T, std::size_t N> constexpr std::size_t lookup_table_index(const std::array<T, N> &boundaries, T val)
+{
+    auto offset{val < boundaries.front() ? 0ULL : offset_from(boundaries.front(), val)};
+    auto last{lookup_table_size(boundaries) - 1};
+    return static_cast<std::size_t>(offset > last ? last : offset);
+}
+
+/**
+ * Selects the search strategy of boundary_mapper. The lookup table is used for integral values when it fits in the
+ * JUNGLES_BOUNDARY_MAPPER_LOOKUP_TABLE_MAX_BYTES budget.
+ */
+template <typename T, std::size_t N, const std::array<T, N> &Boundaries>
+constexpr boundary_search_strategy default_search_strategy()
+{
+    if (fits_lookup_table_budget(Boundaries))
+        return boundary_search_strategy::lookup_table;
+    return default_search_strategy(N);
+}
+
+#if defined(__SSE2__)
+
+//! Wraps the SSE2 (or AVX2, when available) integer intrinsics, so one kernel can be used for 16- and 32-bit lanes.
+struct simd_ops
+{
+#if defined(__AVX2__)
+    using vec = __m256i;
+    static constexpr std::size_t width = 32;
+
+    static vec load(const void *p)
+    {
+        return _mm256_loadu_si256(static_cast<const vec *>(p));
+    }
+
+    static void store(void *p, vec v)
+    {
+        _mm256_storeu_si256(static_cast<vec *>(p), v);
+    }
+
+    static vec zero()
+    {
+        return _mm256_setzero_si256();
+    }
+
+    template <std::size_t LaneSize> static vec broadcast(int32_t v)
+    {
+        if constexpr (LaneSize == 2)
+            return _mm256_set1_epi16(static_cast<int16_t>(v));
+        else
+            return _mm256_set1_epi32(v);
+    }
+
+    template <std::size_t LaneSize> static vec cmpgt(vec a, vec b)
+    {
+        if constexpr (LaneSize == 2)
+            return _mm256_cmpgt_epi16(a, b);
+        else
+            return _mm256_cmpgt_epi32(a, b);
+    }
+
+    template <std::size_t LaneSize> static vec sub(vec a, vec b)
+    {
+        if constexpr (LaneSize == 2)
+            return _mm256_sub_epi16(a, b);
+        else
+            return _mm256_sub_epi32(a, b);
+    }
+
+    static vec bitwise_xor(vec a, vec b)
+    {
+        return _mm256_xor_si256(a, b);
+    }
+#else
+    using vec = __m128i;
+    static constexpr std::size_t width = 16;
+
+    static vec load(const void *p)
+    {
+        return _mm_loadu_si128(static_cast<const vec *>(p));
+    }
+
+    static void store(void *p, vec v)
+    {
+        _mm_storeu_si128(static_cast<vec *>(p), v);
+    }
+
+    static vec zero()
+    {
+        return _mm_setzero_si128();
+    }
+
+    template <std::size_t LaneSize> static vec broadcast(int32_t v)
+    {
+        if constexpr (LaneSize == 2)
+            return _mm_set1_epi16(static_cast<int16_t>(v));
+        else
+            return _mm_set1_epi32(v);
+    }
+
+    template <std::size_t LaneSize> static vec cmpgt(vec a, vec b)
+    {
+        if constexpr (LaneSize == 2)
+            return _mm_cmpgt_epi16(a, b);
+        else
+            return _mm_cmpgt_epi32(a, b);
+    }
+
+    template <std::size_t LaneSize> static vec sub(vec a, vec b)
+    {
+        if constexpr (LaneSize == 2)
+            return _mm_sub_epi16(a, b);
+        else
+            return _mm_sub_epi32(a, b);
+    }
+
+    static vec bitwise_xor(vec a, vec b)
+    {
+        return _mm_xor_si128(a, b);
+    }
+#endif
+};
+
+/**
+ * The SIMD kernel is used for 16- and 32-bit integers. It compares each value with all the boundaries, so it beats
+ * the scalar search only when there are no more boundaries than two times the number of lanes in a vector, and the
+ * lookup table only when there are no more boundaries than lanes (measured with the benchmarks in
+ * test_boundary_mapper.cpp).
+ */
+template <typename T, std::size_t N, boundary_search_strategy Strategy>
+inline constexpr bool is_simd_convertible_v{
+    std::is_integral_v<T> && (sizeof(T) == 2 || sizeof(T) == 4) &&
+    N <= (Strategy == boundary_search_strategy::lookup_table ? 1 : 2) * simd_ops::width / sizeof(T)};
+
+/**
+ * Converts as many values as fit in whole vectors and returns the number of the converted values. Each of the
+ * boundaries is broadcast to a vector and compared against a vector of values. The comparison sets all bits of the
+ * lanes which are greater than the boundary, so subtracting the result counts the boundaries lower than each of the
+ * values. There is no branch depending on the values. The unsigned values are compared as signed ones after flipping
+ * the sign bit.
+ */
+template <typename Enum, typename T, std::size_t N>
+std::size_t simd_convert_many(const std::array<T, N> &boundaries, const T *in, std::size_t n, Enum *out)
+{
+    constexpr std::size_t lane_size{sizeof(T)};
+    constexpr std::size_t num_lanes{simd_ops::width / lane_size};
+    using Lane = std::conditional_t<lane_size == 2, int16_t, int32_t>;
+    constexpr auto sign_flip{std::is_unsigned_v<T> ? static_cast<int32_t>(std::numeric_limits<Lane>::min()) : 0};
+
+    const auto flip{simd_ops::broadcast<lane_size>(sign_flip)};
+    const std::size_t num_converted{n - n % num_lanes};
+    for (std::size_t i = 0; i < num_converted; i += num_lanes)
+    {
+        auto values{simd_ops::bitwise_xor(simd_ops::load(in + i), flip)};
+        auto counts{simd_ops::zero()};
+        for (std::size_t b = 0; b < N; ++b)
+        {
+            auto boundary{simd_ops::broadcast<lane_size>(static_cast<Lane>(boundaries[b]) ^ sign_flip)};
+            counts = simd_ops::sub<lane_size>(counts, simd_ops::cmpgt<lane_size>(values, boundary));
+        }
+
+        Lane lanes[num_lanes];
+        simd_ops::store(lanes, counts);
+        for (std::size_t l = 0; l < num_lanes; ++l)
+            out[i + l] = static_cast<Enum>(lanes[l]);
+    }
+    return num_converted;
+}
+
+#endif
+
 } // namespace detail
 
 /**
@@ -64,11 +443,17 @@ template <class ForwardIt> constexpr bool is_ascending(ForwardIt first, ForwardI
  * auto-deduction.
  *
  * Usage example: map ADC values from leaf wetness sensor to levels of wetness.
+ *
+ * The search strategy is selected at compile time from the value type and the boundaries (see
+ * boundary_search_strategy), but can be forced with the Strategy template parameter. E.g. for ADC readings the whole
+ * range between the lowest and the highest boundary is usually small, so it is converted with a lookup table.
  */
 template <typename Enum,
           typename ValueType,
           std::size_t NumBoundaries,
-          const std::array<ValueType, NumBoundaries> &Boundaries>
+          const std::array<ValueType, NumBoundaries> &Boundaries,
+          boundary_search_strategy Strategy =
+              detail::default_search_strategy<ValueType, NumBoundaries, Boundaries>()>
 class boundary_mapper
 {
     static_assert(std::is_enum_v<Enum>, "The first template argument must be an enum");
@@ -77,26 +462,69 @@ class boundary_mapper
     static_assert(NumBoundaries >= 1, "There must be at least two boundaries");
 
   public:
+    using enum_type = Enum;
+    using value_type = ValueType;
+
     constexpr Enum convert(ValueType val) const
     {
-        unsigned i = 0;
-        for (; i < m_num_boundaries; ++i)
-            if (val <= m_boundaries[i])
-                break;
-        return static_cast<Enum>(i);
+        return static_cast<Enum>(find_interval(val));
+    }
+
+    /**
+     * \brief Converts n values from the in array and stores the results to the out array.
+     *
+     * On x86 the 16- and 32-bit integer values are converted in vectors of SSE2 or AVX2 (when enabled at compile
+     * time) registers, without per-value branches. The remaining values, and all the values on other platforms, are
+     * converted one by one with convert().
+     */
+    void convert_many(const ValueType *in, std::size_t n, Enum *out) const
+    {
+        std::size_t i = 0;
+#if defined(__SSE2__)
+        if constexpr (detail::is_simd_convertible_v<ValueType, NumBoundaries, Strategy>)
+            i = detail::simd_convert_many(Boundaries, in, n, out);
+#endif
+        for (; i < n; ++i)
+            out[i] = convert(in[i]);
     }
 
   private:
-    const std::array<ValueType, NumBoundaries> &m_boundaries = Boundaries;
-    const std::size_t m_num_boundaries = NumBoundaries + 1;
+    static constexpr std::size_t find_interval(ValueType val)
+    {
+        if constexpr (Strategy == boundary_search_strategy::linear)
+        {
+            return detail::linear_lower_bound(Boundaries, val, std::make_index_sequence<NumBoundaries>());
+        }
+        else if constexpr (Strategy == boundary_search_strategy::binary)
+        {
+            return detail::branchless_lower_bound(Boundaries.data(), NumBoundaries, val);
+        }
+        else if constexpr (Strategy == boundary_search_strategy::eytzinger)
+        {
+            constexpr auto &layout{detail::eytzinger_layout_of<ValueType, NumBoundaries, Boundaries>};
+            return detail::eytzinger_lower_bound(layout.values.data(), layout.ranks.data(), NumBoundaries, val);
+        }
+        else
+        {
+            static_assert(std::is_integral_v<ValueType>, "The lookup table can be used only for integral values");
+            constexpr auto &table{detail::lookup_table_of<ValueType, NumBoundaries, Boundaries>};
+            return table[detail::lookup_table_index(Boundaries, val)];
+        }
+    }
 };
 
-template <typename Enum, const auto &Boundaries> constexpr auto make_boundary_mapper()
+template <typename Enum,
+          const auto &Boundaries,
+          boundary_search_strategy Strategy = detail::default_search_strategy<
+              typename std::decay_t<decltype(Boundaries)>::value_type,
+              std::size(Boundaries),
+              Boundaries>()>
+constexpr auto make_boundary_mapper()
 {
     using T = std::decay_t<decltype(Boundaries)>;
     using V = typename T::value_type;
     constexpr auto N = std::size(Boundaries);
-    return boundary_mapper<Enum, V, N, Boundaries>();
+    return boundary_mapper<Enum, V, N, Boundaries, Strategy>();
 }
 
 } // namespace jungles
@@ -0,0 +1,140 @@
+/**
+ * @file	boundary_transition_stream.hpp
+ * @brief	Streams values through a boundary mapper and reports only the changes of the mapped level.
+ * @author	Kacper Kowalski - kacper.s.kowalski@gmail.com
+ */
+
+#ifndef BOUNDARY_TRANSITION_STREAM_HPP
+#define BOUNDARY_TRANSITION_STREAM_HPP
+
+#include <cassert>
+#include <cstdint>
+#include <limits>
+#include <optional>
+
+namespace jungles {
+
+namespace detail {
+
+template <typename T> constexpr T saturating_sub(T val, T delta)
+{
+    return val < std::numeric_limits<T>::lowest() + delta ? std::numeric_limits<T>::lowest()
+                                                          : static_cast<T>(val - delta);
+}
+
+template <typename T> constexpr T saturating_add(T val, T delta)
+{
+    return val > std::numeric_limits<T>::max() - delta ? std::numeric_limits<T>::max() : static_cast<T>(val + delta);
+}
+
+} // namespace detail
+
+//! Tells that starting from the sample under the index the values are mapped to the level.
+template <typename Enum> struct level_transition
+{
+    uint64_t index;
+    Enum level;
+
+    constexpr bool operator==(const level_transition &other) const
+    {
+        return index == other.index && level == other.level;
+    }
+};
+
+/**
+ * \brief Maps blocks of samples with a boundary mapper and outputs only the transitions between levels.
+ *
+ * The samples are indexed from 0, counting from the construction or the last reset(), across all the pushed blocks.
+ * The first sample always produces a transition, to tell the initial level.
+ *
+ * Optionally a hysteresis can be specified. Then a value must exceed a boundary by more than the hysteresis to move
+ * the level up, and it must be lower than the boundary by at least the hysteresis to move the level down. This
+ * suppresses flapping when the values oscillate around a boundary. The hysteresis is the same for all the boundaries.
+ *
+ * \tparam Mapper boundary_mapper or runtime_boundary_mapper. The mapper must outlive this object.
+ */
+template <typename Mapper> class boundary_transition_stream
+{
+  public:
+    using Enum = typename Mapper::enum_type;
+    using ValueType = typename Mapper::value_type;
+    using transition = level_transition<Enum>;
+
+    explicit boundary_transition_stream(const Mapper &mapper, ValueType hysteresis = ValueType{})
+        : m_mapper{mapper}, m_hysteresis{hysteresis}
+    {
+        assert(!(hysteresis < ValueType{}));
+    }
+
+    /**
+     * \brief Maps the values from the range <first, last) and writes the transitions to out.
+     *
+     * \returns Output iterator to the element past the last written transition.
+     */
+    template <typename InputIt, typename OutputIt> OutputIt push(InputIt first, InputIt last, OutputIt out)
+    {
+        for (; first != last; ++first)
+            if (auto t{push(*first)}; t)
+                *out++ = *t;
+        return out;
+    }
+
+    //! Maps the single value and returns the transition, if the level has changed.
+    std::optional<transition> push(ValueType val)
+    {
+        auto index{m_index++};
+        auto new_level{next_level(val)};
+        if (m_is_level_known && m_level == new_level)
+            return {};
+
+        m_level = new_level;
+        m_is_level_known = true;
+        return transition{index, new_level};
+    }
+
+    //! Returns the current level, if any sample has been pushed.
+    std::optional<Enum> level() const
+    {
+        if (m_is_level_known)
+            return m_level;
+        return {};
+    }
+
+    //! Forgets the current level and starts indexing the samples from 0.
+    void reset()
+    {
+        m_is_level_known = false;
+        m_index = 0;
+    }
+
+  private:
+    const Mapper &m_mapper;
+    const ValueType m_hysteresis;
+    Enum m_level{};
+    bool m_is_level_known{false};
+    uint64_t m_index{0};
+
+    Enum next_level(ValueType val) const
+    {
+        auto raw_level{m_mapper.convert(val)};
+        if (!m_is_level_known || raw_level == m_level)
+            return raw_level;
+
+        // Shifting the value by the hysteresis towards the current level tells whether the value is outside the
+        // hysteresis band of the boundary, and if so, to which level.
+        if (raw_level > m_level)
+        {
+            auto level{m_mapper.convert(detail::saturating_sub(val, m_hysteresis))};
+            return level > m_level ? level : m_level;
+        }
+        else
+        {
+            auto level{m_mapper.convert(detail::saturating_add(val, m_hysteresis))};
+            return level < m_level ? level : m_level;
+        }
+    }
+};
+
+} // namespace jungles
+
+#endif /* BOUNDARY_TRANSITION_STREAM_HPP */
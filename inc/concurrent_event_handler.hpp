@@ -0,0 +1,196 @@
+/**
+ * @file	concurrent_event_handler.hpp
+ * @brief	Implements an event handler which can be raised and updated from multiple threads.
+ * @author	Kacper Kowalski - kacper.s.kowalski@gmail.com
+ */
+
+#ifndef CONCURRENT_EVENT_HANDLER_HPP
+#define CONCURRENT_EVENT_HANDLER_HPP
+
+#include "inplace_function.hpp"
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace jungles {
+
+// --------------------------------------------------------------------------------------------------------------------
+// DECLARATIONS FOR PUBLIC USE
+// --------------------------------------------------------------------------------------------------------------------
+
+/**
+ * \brief       The thread-safe counterpart of the basic_event_handler.
+ *
+ * raise() may be called from many threads at once, while other threads register the handlers. raise() iterates
+ * over an immutable snapshot of the handlers, which it obtains with an atomic load of a raw pointer, after it has
+ * registered itself in the counter of the running raise() calls. raise() never takes a lock nor waits for anything.
+ *
+ * A registration copies the current snapshot, adds the handler to the copy and publishes the copy. The replaced
+ * snapshot is retired: it is freed by the first update, or the first raise() finishing as the last running one,
+ * which sees no raise() running. When raise() is called all the time from many threads at once, so that no such
+ * moment happens, the retired snapshots pile up.
+ *
+ * A handler is invoked from whichever thread calls raise(), possibly from several threads at once, so it must be
+ * thread-safe itself. When a handler returns deregister it is skipped by the raise() calls which start later, but it
+ * may still be invoked by the raise() calls which run concurrently. The handler is removed from the snapshot by the
+ * next update, which may be done by a raise() only if it acquires the update mutex without waiting.
+ *
+ * Unlike the basic_event_handler, the handlers registered by a handler may be invoked by the concurrent raise()
+ * calls, but never by the raise() which invokes the registering handler.
+ */
+template <typename... Args> class concurrent_event_handler
+{
+  public:
+    enum policy
+    {
+        keep,
+        deregister
+    };
+
+    using handler_type = inplace_function<policy(Args &...)>;
+
+    concurrent_event_handler() = default;
+    concurrent_event_handler(const concurrent_event_handler &) = delete;
+    concurrent_event_handler &operator=(const concurrent_event_handler &) = delete;
+    ~concurrent_event_handler();
+
+    //! Takes anything what binds to Args&, temporaries as well, as they live until raise() returns.
+    template <typename... Ts> void raise(Ts &&...args);
+    void register_handler(handler_type handler);
+
+  private:
+    struct entry
+    {
+        explicit entry(handler_type h) : handler{std::move(h)}
+        {
+        }
+
+        handler_type handler;
+        std::atomic<bool> is_deregistered{false};
+    };
+
+    //! The entries are shared between the snapshots, but only the updates, made under the mutex, copy them.
+    using snapshot = std::vector<std::shared_ptr<entry>>;
+
+    std::atomic<const snapshot *> m_snapshot{new snapshot};
+    std::atomic<unsigned> m_num_raising{0};
+    std::atomic<bool> m_has_deregistered{false};
+    std::atomic<bool> m_has_retired{false};
+
+    //! Serializes the updates of the snapshot and guards m_retired.
+    std::mutex m_update_mutex;
+    std::vector<std::unique_ptr<const snapshot>> m_retired;
+
+    //! Must be called with the update mutex locked.
+    std::unique_ptr<snapshot> copy_without_deregistered();
+
+    //! Must be called with the update mutex locked.
+    void publish(std::unique_ptr<snapshot> next);
+
+    //! Must be called with the update mutex locked. Frees the retired snapshots when no raise() runs.
+    void reclaim();
+
+    //! Removes the deregistered handlers and frees the retired snapshots, unless the update mutex is locked.
+    void try_update();
+};
+
+// --------------------------------------------------------------------------------------------------------------------
+// DEFINITIONS OF PUBLIC STUFF
+// --------------------------------------------------------------------------------------------------------------------
+template <typename... Args> concurrent_event_handler<Args...>::~concurrent_event_handler()
+{
+    delete m_snapshot.load(std::memory_order_relaxed);
+}
+
+template <typename... Args>
+template <typename... Ts>
+void concurrent_event_handler<Args...>::raise(Ts &&...args)
+{
+    static_assert(sizeof...(Ts) == sizeof...(Args), "raise() must be given one argument for each of the Args");
+
+    // Both are sequentially consistent and so are the operations in publish() and reclaim(): an update which sees no
+    // raise() running knows that any raise() which starts later loads the published snapshot.
+    m_num_raising.fetch_add(1, std::memory_order_seq_cst);
+    auto handlers{m_snapshot.load(std::memory_order_seq_cst)};
+    for (auto &e : *handlers)
+    {
+        if (e->is_deregistered.load(std::memory_order_relaxed))
+            continue;
+        if (e->handler(args...) == policy::deregister)
+        {
+            e->is_deregistered.store(true, std::memory_order_relaxed);
+            // Pairs with the fence in copy_without_deregistered(): either the copy skips the handler or the flag is
+            // set again after it has been cleared there.
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            m_has_deregistered.store(true, std::memory_order_relaxed);
+        }
+    }
+    auto is_last{m_num_raising.fetch_sub(1, std::memory_order_seq_cst) == 1};
+
+    auto can_reclaim{is_last && m_has_retired.load(std::memory_order_relaxed)};
+    if (can_reclaim || m_has_deregistered.load(std::memory_order_relaxed))
+        try_update();
+}
+
+template <typename... Args> void concurrent_event_handler<Args...>::register_handler(handler_type handler)
+{
+    std::lock_guard<std::mutex> lock{m_update_mutex};
+    auto next{copy_without_deregistered()};
+    next->emplace_back(std::make_shared<entry>(std::move(handler)));
+    publish(std::move(next));
+}
+
+// --------------------------------------------------------------------------------------------------------------------
+// DEFINITIONS OF PRIVATE STUFF
+// --------------------------------------------------------------------------------------------------------------------
+template <typename... Args>
+std::unique_ptr<typename concurrent_event_handler<Args...>::snapshot>
+concurrent_event_handler<Args...>::copy_without_deregistered()
+{
+    // Cleared before the copy is made, so a handler deregistered in the meantime is removed by the next update.
+    m_has_deregistered.store(false, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+    auto current{m_snapshot.load(std::memory_order_relaxed)};
+    auto next{std::make_unique<snapshot>()};
+    next->reserve(current->size() + 1);
+    for (auto &e : *current)
+        if (!e->is_deregistered.load(std::memory_order_relaxed))
+            next->push_back(e);
+    return next;
+}
+
+template <typename... Args> void concurrent_event_handler<Args...>::publish(std::unique_ptr<snapshot> next)
+{
+    m_retired.emplace_back(m_snapshot.exchange(next.release(), std::memory_order_seq_cst));
+    m_has_retired.store(true, std::memory_order_relaxed);
+    reclaim();
+}
+
+template <typename... Args> void concurrent_event_handler<Args...>::reclaim()
+{
+    // A raise() which still uses a retired snapshot has been counted before the snapshot was replaced.
+    if (m_num_raising.load(std::memory_order_seq_cst) != 0)
+        return;
+    m_has_retired.store(false, std::memory_order_relaxed);
+    m_retired.clear();
+}
+
+template <typename... Args> void concurrent_event_handler<Args...>::try_update()
+{
+    std::unique_lock<std::mutex> lock{m_update_mutex, std::try_to_lock};
+    if (!lock.owns_lock())
+        return;
+
+    if (m_has_deregistered.load(std::memory_order_relaxed))
+        publish(copy_without_deregistered());
+    else
+        reclaim();
+}
+
+} // namespace jungles
+
+#endif /* CONCURRENT_EVENT_HANDLER_HPP */
@@ -9,6 +9,9 @@
 
 #include <cstddef>
 #include <algorithm>
+#include <atomic>
+#include <string>
+#include <string_view>
 
 //! Checks whether the number is a power of two. Might be used at compile time. @todo Export that to other file.
 constexpr static bool is_power_of_two(unsigned int n)
@@ -19,6 +22,51 @@ constexpr static bool is_power_of_two(unsigned int n)
 	return (n & (n - 1)) == 0;
 }
 
+/**
+ * \brief Consecutive chars held in a cyclic buffer, viewed without copying them.
+ *
+ *	The second view is empty, unless the chars wrap around the end of the buffer.
+ */
+struct cyclic_buf_string_view
+{
+	std::string_view first;
+	std::string_view second;
+
+	size_t size() const noexcept
+	{
+		return first.size() + second.size();
+	}
+
+	bool empty() const noexcept
+	{
+		return size() == 0;
+	}
+
+	//! Replaces the contents of the string, reusing its capacity.
+	void copy_to(std::string &s) const
+	{
+		s.assign(first);
+		s.append(second);
+	}
+
+	/**
+	 * \brief Copies the chars to p, truncated to n - 1 chars, and null-terminates them, like snprintf().
+	 * \returns The number of the chars viewed, thus a result not lower than n means truncation.
+	 */
+	size_t copy_to(char *p, size_t n) const noexcept
+	{
+		if (n == 0)
+			return size();
+
+		size_t len_first = std::min(first.size(), n - 1);
+		size_t len_second = std::min(second.size(), n - 1 - len_first);
+		std::copy_n(first.data(), len_first, p);
+		std::copy_n(second.data(), len_second, p + len_first);
+		p[len_first + len_second] = '\0';
+		return size();
+	}
+};
+
 /**
  * \brief The cyclic buffer.
  *
@@ -26,14 +74,19 @@ constexpr static bool is_power_of_two(unsigned int n)
  *	new elements in the buffer (when the head is the same as the tail). 
  *
  *	The size of the buffer must be a power of two to increment the tail and the head efficiently.
+ *
+ *	The buffer may be pushed to from an interrupt and popped from the main loop, or the other way round, on the same
+ *	core. The head and the tail are volatile, and the elements are written before and read after them, which is
+ *	ensured with signal fences.
  */
 template <typename T, size_t N> struct cyclic_buf
 {
 	// Do not allow to compile when the size isn't a power of two.
 	static_assert(is_power_of_two(N), "The size of the cyclic buffer must be a power of two");
 
-	//! The buffer where the data is stored.
-	volatile T buf[N];
+	//! The buffer where the data is stored. Not volatile, so the elements can be viewed with peek_nelems(); the
+	//! signal fences order the accesses to the elements against the accesses to the head and the tail.
+	T buf[N];
 
 	//! The size of the buffer. Must be a power of two.
 	const unsigned int size;
@@ -62,6 +115,16 @@ template <typename T, size_t N> struct cyclic_buf
 	//! Pops n elements from the buffer int to the specified array.
 	void pop_nelems(T *p, unsigned int n) noexcept;
 
+	//! Returns the element which would be popped next, without popping it.
+	T peek_elem() const noexcept;
+
+	/**
+	 * \brief Views n elements from the tail without popping them. Can be used with cyclic_buf<char, N> only.
+	 *
+	 *	The viewed elements are not written until they are popped, so the view stays valid until then.
+	 */
+	cyclic_buf_string_view peek_nelems(unsigned int n) const noexcept;
+
 	//! Checks whether the cyclic buffer is empty.
 	bool is_empty() const noexcept;
 
@@ -75,6 +138,7 @@ template <typename T, size_t N> void cyclic_buf<T, N>::push_elem(T val) noexcept
 {
 	unsigned int h = head;
 	buf[h] = val;
+	std::atomic_signal_fence(std::memory_order_release);
 	head = (h + 1) & mask;
 }
 
@@ -87,7 +151,7 @@ template <typename T, size_t N> void cyclic_buf<T, N>::push_nelems(const T *p, u
 		return;
 
 	unsigned int h = head, s = size;
-	volatile T *beg = &buf[h];
+	T *beg = &buf[h];
 
 	// We must check whether there a swing of the buffer will occur. If yes then the data must be splitted
 	// into two parts. The first one will be copied at the end of the buffer and the second one will be copied
@@ -104,14 +168,18 @@ template <typename T, size_t N> void cyclic_buf<T, N>::push_nelems(const T *p, u
 		std::copy(p, p + n, beg);
 	}
 
+	std::atomic_signal_fence(std::memory_order_release);
 	head = (h + n) & mask;
 }
 
 template <typename T, size_t N> T cyclic_buf<T, N>::pop_elem() noexcept
 {
 	unsigned int t = tail;
+	std::atomic_signal_fence(std::memory_order_acquire);
+	T val = buf[t];
+	std::atomic_signal_fence(std::memory_order_release);
 	tail = (t + 1) & mask;
-	return buf[t];
+	return val;
 }
 
 template <typename T, size_t N> bool cyclic_buf<T, N>::is_empty() const noexcept
@@ -137,7 +205,8 @@ template <typename T, size_t N> void cyclic_buf<T, N>::pop_nelems(T *p, unsigned
 		return;
 
 	unsigned int t = tail, s = size;
-	volatile T *beg = &buf[t];
+	const T *beg = &buf[t];
+	std::atomic_signal_fence(std::memory_order_acquire);
 
 	// We must check whether there a swing of the buffer will occur. If yes then the data must be splitted
 	// into two parts. The first one will be copied from the end of the buffer and the second one will be copied
@@ -154,7 +223,28 @@ template <typename T, size_t N> void cyclic_buf<T, N>::pop_nelems(T *p, unsigned
 		std::copy(beg, beg + n, p);
 	}
 
+	std::atomic_signal_fence(std::memory_order_release);
 	tail = (t + n) & mask;
 }
 
+template <typename T, size_t N> T cyclic_buf<T, N>::peek_elem() const noexcept
+{
+	unsigned int t = tail;
+	std::atomic_signal_fence(std::memory_order_acquire);
+	return buf[t];
+}
+
+template <typename T, size_t N> cyclic_buf_string_view cyclic_buf<T, N>::peek_nelems(unsigned int n) const noexcept
+{
+	unsigned int t = tail, s = size;
+	const char *beg = &buf[t];
+	std::atomic_signal_fence(std::memory_order_acquire);
+
+	size_t size_to_end = s - t;
+	if (size_to_end < n)
+		return {{beg, size_to_end}, {buf, n - size_to_end}};
+	else
+		return {{beg, n}, {}};
+}
+
 #endif /* CYCLIC_BUF_HPP */
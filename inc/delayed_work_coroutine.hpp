@@ -0,0 +1,270 @@
+/**
+ * @file	delayed_work_coroutine.hpp
+ * @brief	Allows to write timed sequences, run by the delayed_work_manager, as C++20 coroutines.
+ * @author	Kacper Kowalski - kacper.s.kowalski@gmail.com
+ */
+
+#ifndef DELAYED_WORK_COROUTINE_HPP
+#define DELAYED_WORK_COROUTINE_HPP
+
+#if defined(__cpp_impl_coroutine) && __has_include(<coroutine>)
+
+#include "delayed_work_manager.hpp"
+
+#include <array>
+#include <cstddef>
+#include <coroutine>
+#include <exception>
+#include <new>
+
+namespace jungles {
+
+namespace detail {
+
+//! Precedes each coroutine frame, so the frame can be given back to where it was allocated from.
+struct coroutine_frame_header
+{
+    void (*deallocate)(void *allocator, void *block);
+    void *allocator;
+};
+
+//! Keeps the frame aligned the same as memory returned by operator new.
+constexpr std::size_t coroutine_frame_header_size{
+    (sizeof(coroutine_frame_header) + alignof(std::max_align_t) - 1) / alignof(std::max_align_t) *
+    alignof(std::max_align_t)};
+
+inline void *place_coroutine_frame(void *block, void (*deallocate)(void *, void *), void *allocator)
+{
+    if (block == nullptr)
+        return nullptr;
+    ::new (block) coroutine_frame_header{deallocate, allocator};
+    return static_cast<std::byte *>(block) + coroutine_frame_header_size;
+}
+
+} // namespace detail
+
+/**
+ * \brief A pool of memory blocks for coroutine frames, so that starting a coroutine doesn't allocate.
+ *
+ * Pass the pool as the first parameter of a coroutine returning delayed_task to allocate its frame from the pool:
+ *
+ * jungles::delayed_task measure(jungles::coroutine_frame_pool<256, 4> &, delayed_work_manager<10> &manager);
+ *
+ * The size of the frame is known only to the compiler, so the BlockSize must be found by trial: when the frame doesn't
+ * fit, the coroutine is not started, see delayed_task::is_started(). Not thread safe.
+ *
+ * \tparam BlockSize The size of a block, which holds a coroutine frame and a small header.
+ * \tparam NumBlocks The maximum number of the coroutines running at once.
+ */
+template <std::size_t BlockSize, std::size_t NumBlocks> class coroutine_frame_pool
+{
+  public:
+    coroutine_frame_pool()
+    {
+        for (auto &b : m_blocks)
+            deallocate(&b);
+    }
+
+    coroutine_frame_pool(const coroutine_frame_pool &) = delete;
+    coroutine_frame_pool &operator=(const coroutine_frame_pool &) = delete;
+
+    //! Returns nullptr when the size exceeds the BlockSize or when all the blocks are in use.
+    void *allocate(std::size_t size)
+    {
+        if (size > BlockSize || m_free == nullptr)
+            return nullptr;
+        auto b{m_free};
+        m_free = b->next;
+        --m_num_free;
+        return b;
+    }
+
+    void deallocate(void *p)
+    {
+        auto b{static_cast<block *>(p)};
+        b->next = m_free;
+        m_free = b;
+        ++m_num_free;
+    }
+
+    std::size_t num_free_blocks() const
+    {
+        return m_num_free;
+    }
+
+  private:
+    union alignas(std::max_align_t) block
+    {
+        block *next;
+        std::byte data[BlockSize];
+    };
+
+    std::array<block, NumBlocks> m_blocks;
+    block *m_free{nullptr};
+    std::size_t m_num_free{0};
+};
+
+/**
+ * \brief The return type of coroutines which are run by the delayed_work_manager.
+ *
+ * The coroutine starts immediately and runs until it awaits sleep_for(). It is then resumed by the manager, from
+ * invoke(), after the period passes. The frame is freed when the coroutine finishes. The returned object only tells
+ * whether the coroutine has been started.
+ *
+ * The frame is allocated from a coroutine_frame_pool, when it is the first parameter of the coroutine, or with
+ * operator new otherwise.
+ *
+ * A coroutine which sleeps when the manager is destroyed is never resumed, so its frame, together with its local
+ * variables, is never freed. Destroy the manager only after all its coroutines have finished.
+ */
+class delayed_task
+{
+  public:
+    struct promise_type
+    {
+        delayed_task get_return_object() noexcept
+        {
+            return delayed_task{true};
+        }
+
+        static delayed_task get_return_object_on_allocation_failure() noexcept
+        {
+            return delayed_task{false};
+        }
+
+        std::suspend_never initial_suspend() noexcept
+        {
+            return {};
+        }
+
+        std::suspend_never final_suspend() noexcept
+        {
+            return {};
+        }
+
+        void return_void() noexcept
+        {
+        }
+
+        void unhandled_exception() noexcept
+        {
+            std::terminate();
+        }
+
+        static void *operator new(std::size_t size) noexcept
+        {
+            auto deallocate{[](void *, void *block) { ::operator delete(block); }};
+            return detail::place_coroutine_frame(
+                ::operator new(size + detail::coroutine_frame_header_size, std::nothrow), deallocate, nullptr);
+        }
+
+        static void operator delete(void *frame) noexcept
+        {
+            auto block{static_cast<std::byte *>(frame) - detail::coroutine_frame_header_size};
+            auto header{std::launder(reinterpret_cast<detail::coroutine_frame_header *>(block))};
+            header->deallocate(header->allocator, block);
+        }
+    };
+
+    /**
+     * The promise of the coroutines which take a coroutine_frame_pool as the first parameter, chosen by the
+     * std::coroutine_traits specialization below. Args are the types of the other parameters. The class, not the
+     * operator new, is a template, so the frame is freed with the operator delete of the same class as it was
+     * allocated with.
+     */
+    template <std::size_t BlockSize, std::size_t NumBlocks, typename... Args> struct pooled_promise_type : promise_type
+    {
+        using pool_type = coroutine_frame_pool<BlockSize, NumBlocks>;
+
+        static void *operator new(std::size_t size, pool_type &pool, Args &...) noexcept
+        {
+            auto deallocate{[](void *allocator, void *block) {
+                static_cast<pool_type *>(allocator)->deallocate(block);
+            }};
+            return detail::place_coroutine_frame(
+                pool.allocate(size + detail::coroutine_frame_header_size), deallocate, &pool);
+        }
+
+        static void operator delete(void *frame) noexcept
+        {
+            promise_type::operator delete(frame);
+        }
+    };
+
+    //! Returns false when the frame couldn't be allocated, so the coroutine hasn't run at all.
+    bool is_started() const noexcept
+    {
+        return m_is_started;
+    }
+
+  private:
+    explicit delayed_task(bool is_started) noexcept : m_is_started(is_started)
+    {
+    }
+
+    bool m_is_started;
+};
+
+//! The awaitable returned by sleep_for().
+template <typename Manager, typename Period> class sleep_awaiter
+{
+  public:
+    sleep_awaiter(Manager &manager, Period period) : m_manager(manager), m_period(period)
+    {
+    }
+
+    bool await_ready() const noexcept
+    {
+        return false;
+    }
+
+    bool await_suspend(std::coroutine_handle<> h)
+    {
+        auto handle{m_manager.register_work(m_period, [h]() {
+            h.resume();
+            return delayed_work_policy::deregister;
+        })};
+        m_is_slept = handle.is_registered();
+        return m_is_slept;
+    }
+
+    //! Returns false when the manager has a fixed capacity and it was full, so the coroutine hasn't slept.
+    bool await_resume() const noexcept
+    {
+        return m_is_slept;
+    }
+
+  private:
+    Manager &m_manager;
+    Period m_period;
+    bool m_is_slept{false};
+};
+
+/**
+ * \brief Suspends the coroutine until the manager invokes its work after the period.
+ *
+ * co_await sleep_for(manager, 50ms);
+ *
+ * The period is anything accepted by delayed_work_manager::register_work(). While sleeping, the coroutine takes one
+ * job of the manager. The manager must have no executor, as the coroutine registers further work when it is resumed.
+ */
+template <typename Manager, typename Period> sleep_awaiter<Manager, Period> sleep_for(Manager &manager, Period period)
+{
+    return {manager, period};
+}
+
+} // namespace jungles
+
+namespace std {
+
+template <std::size_t BlockSize, std::size_t NumBlocks, typename... Args>
+struct coroutine_traits<jungles::delayed_task, jungles::coroutine_frame_pool<BlockSize, NumBlocks> &, Args...>
+{
+    using promise_type = jungles::delayed_task::pooled_promise_type<BlockSize, NumBlocks, Args...>;
+};
+
+} // namespace std
+
+#endif /* defined(__cpp_impl_coroutine) && __has_include(<coroutine>) */
+
+#endif /* DELAYED_WORK_COROUTINE_HPP */
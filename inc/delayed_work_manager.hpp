@@ -7,31 +7,224 @@
 #ifndef DELAYED_WORK_MANAGER_HPP
 #define DELAYED_WORK_MANAGER_HPP
 
+#include "inplace_function.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
 #include <cassert>
-#include <functional>
-#include <list>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <limits>
+#include <optional>
+#include <type_traits>
+#include <utility>
 
 // Those structures are defined under the delayed_work_manager class.
 enum class delayed_work_policy;
 struct delayed_work;
+struct instrumented_delayed_work;
+template <bool IsEnabled> struct delayed_work_manager_instrumentation;
+
+/**
+ * The number of the jobs which can be submitted with delayed_work_manager::submit_work() and wait for the next call to
+ * invoke(), when the pool of the manager grows on demand. Must be a power of two. Define it globally to change the
+ * default.
+ */
+#ifndef JUNGLES_DELAYED_WORK_SUBMISSION_QUEUE_SIZE
+#define JUNGLES_DELAYED_WORK_SUBMISSION_QUEUE_SIZE 16
+#endif
+
+//! The default size of the submission queue: a manager with a fixed capacity can take that many jobs in one tick.
+constexpr std::size_t default_delayed_work_submission_queue_size(std::size_t capacity)
+{
+    if (capacity == 0)
+        return JUNGLES_DELAYED_WORK_SUBMISSION_QUEUE_SIZE;
+    std::size_t size{1};
+    while (size < capacity)
+        size <<= 1;
+    return size;
+}
+
+//! The handlers are stored in place, so their size is limited by JUNGLES_INPLACE_FUNCTION_DEFAULT_CAPACITY.
+using delayed_work_handler = jungles::inplace_function<delayed_work_policy(void)>;
+
+//! Runs the passed task, e.g. posts it to jungles::work_stealing_pool.
+using delayed_work_executor = jungles::inplace_function<void(jungles::inplace_function<void(void)>)>;
+
+//! The statistics of a job, collected by an instrumented delayed_work_manager.
+struct delayed_work_stats
+{
+    static constexpr std::size_t num_histogram_buckets = 16;
+
+    uint64_t num_invocations{0};
+
+    /**
+     * Counts the invocations by the execution time of the handler. The bucket 0 counts the executions shorter than
+     * 1 us, the bucket i the ones which took at least 2^(i-1) us and less than 2^i us. The last bucket counts also all
+     * the longer ones.
+     */
+    std::array<uint64_t, num_histogram_buckets> execution_time_histogram{};
+    std::chrono::nanoseconds max_execution_time{0};
+
+    //! By how many ticks the invocations were late, because invoke(elapsed) caught up with them.
+    uint64_t total_lateness_ticks{0};
+    uint64_t max_lateness_ticks{0};
+};
+
+//! The statistics of the ticks, collected by an instrumented delayed_work_manager.
+struct delayed_work_manager_stats
+{
+    //! The number of the ticks processed. The ticks skipped by invoke(elapsed) are not counted.
+    uint64_t num_ticks{0};
+
+    //! The number of the ticks in which the handlers took longer than the invocation period altogether.
+    uint64_t num_overrun_ticks{0};
+    std::chrono::nanoseconds max_tick_execution_time{0};
+};
 
 /**
  * \brief Allows to execute periodically some jobs or single shot jobs with a delay.
  *
- * ACHTUNG#1: this is not thread safe.
- * ACHTUNG#2: Keep the invocation period higher than one second as the internal variables can overflow if the
- *            invocation period is high.
+ * The jobs are kept in a hierarchical timing wheel, so a call to invoke() touches only the jobs which are due, no
+ * matter how many jobs are registered. The wheel has wheel_levels levels of wheel_slots slots. A slot on the level 0
+ * holds the jobs due in a single tick (a call to invoke()), a slot on the level n holds the jobs due in a span of
+ * wheel_slots^n ticks. When the time reaches such a span, its jobs are moved (cascaded) to the lower levels. The jobs
+ * due further than the wheel covers are kept on an overflow list, which is checked once per the wheel rotation.
+ *
+ * The jobs are stored in a pool of slots and the lists of the wheel are linked with the indices of the slots. The
+ * slots of finished jobs are reused, so the registration allocates only when the pool must grow. With a non-zero
+ * Capacity the pool is a fixed array inside the manager, thus the manager never allocates.
+ *
+ * The jobs due in the same tick are invoked in an unspecified order.
+ *
+ * register_work() returns a work_handle, which allows to cancel or reschedule the job in constant time. The handle
+ * stays safe to use after the job finishes, but it must not outlive the manager.
+ *
+ * The manager can also work without being called every invocation period (tickless): call next_deadline() to know
+ * how long the caller can sleep and then call invoke(elapsed) with the time which has actually passed.
+ *
+ * Other threads can register jobs with submit_work(). The submitted jobs are put to a bounded queue of
+ * SubmissionQueueSize entries inside the manager, which is drained by the thread calling invoke() at the beginning
+ * of the tick. Neither the submitting threads nor that thread allocate or wait for a lock.
+ *
+ * When the manager is constructed with an executor, the due handlers are passed to the executor instead of being
+ * invoked by invoke(), so a slow handler doesn't delay the other jobs. The policy returned by such a handler is
+ * applied at the beginning of the first call to invoke() after the handler returns. A periodic job never overlaps
+ * with itself: it is scheduled again only after its handler returns, a period after it was last due, or in the next
+ * tick, when the handler took longer than the period. The handlers run by the executor may register new jobs only
+ * with submit_work(). The executor must finish all the handlers before the manager is destroyed.
+ *
+ * The time is counted in ticks with a 64-bit counter and each job keeps its due tick, so the counters never overflow
+ * in practice, no matter the invocation period.
+ *
+ * An instrumented manager collects the statistics of each of the jobs and of the ticks, see work_handle::stats() and
+ * stats(). The instrumentation is disabled by default and then the manager has no trace of it.
+ *
+ * ACHTUNG: this is not thread safe, except of submit_work(). All the other methods, and the work handles, must be
+ *          used from the thread which calls invoke().
  *
  * \tparam InvocationPeriod The period with which the invoke() method is called.
+ * \tparam Capacity         The maximum number of registered jobs, or 0 for a pool which grows on demand.
+ * \tparam TimeUnit         The std::chrono::duration in which the invocation period and the periods are expressed.
+ * \tparam IsInstrumented   Whether to collect the statistics.
+ * \tparam SubmissionQueueSize The number of the jobs which can wait in the submission queue. Must be a power of two.
+ *                             By default it is the capacity rounded up to a power of two, or
+ *                             JUNGLES_DELAYED_WORK_SUBMISSION_QUEUE_SIZE when the pool grows on demand.
  */
-template <unsigned InvocationPeriod> class delayed_work_manager
+template <unsigned InvocationPeriod,
+          std::size_t Capacity = 0,
+          typename TimeUnit = std::chrono::milliseconds,
+          bool IsInstrumented = false,
+          std::size_t SubmissionQueueSize = default_delayed_work_submission_queue_size(Capacity)>
+class delayed_work_manager : private delayed_work_manager_instrumentation<IsInstrumented>
 {
+  private:
+    using job_index = uint32_t;
+
   public:
-    delayed_work_manager();
+    //! Refers to a registered job. A default constructed handle refers to no job.
+    class work_handle
+    {
+      public:
+        work_handle() = default;
+
+        /**
+         * \brief Deregisters the job, so its handler is not invoked any more.
+         *
+         * Can be called from any handler, including the handler of the job itself.
+         *
+         * \returns false when the job has already been deregistered.
+         */
+        bool cancel();
+
+        /**
+         * \brief Changes the period of the job, which is then due after the new period counting from now.
+         *
+         * When called from the handler of the job itself, the job will be due after the new period counting from
+         * the current invocation, unless the handler deregisters it.
+         *
+         * \returns false when the job has already been deregistered.
+         */
+        bool reschedule(unsigned new_period);
+        bool reschedule(TimeUnit new_period);
+
+        //! Tells whether the job is still registered.
+        bool is_registered() const;
+
+        //! Returns the statistics of the job, or nothing when the job is not registered. Needs the instrumentation.
+        std::optional<delayed_work_stats> stats() const;
+
+      private:
+        friend class delayed_work_manager;
+
+        work_handle(delayed_work_manager *manager, job_index idx, uint32_t generation)
+            : m_manager(manager), m_index(idx), m_generation(generation)
+        {
+        }
+
+        delayed_work_manager *m_manager{nullptr};
+        job_index m_index{0};
+
+        //! Distinguishes the job from the later jobs stored in the same slot of the pool.
+        uint32_t m_generation{0};
+    };
+
+    //! \param[in] executor Runs the due handlers. When empty, the handlers are invoked within invoke().
+    explicit delayed_work_manager(delayed_work_executor executor = nullptr);
+
+    delayed_work_manager(const delayed_work_manager &) = delete;
+    delayed_work_manager &operator=(const delayed_work_manager &) = delete;
 
     //! The function which must be called periodically to invoke registered handlers properly.
     void invoke();
 
+    /**
+     * \brief Advances the time by the elapsed time and invokes all the handlers which were due in the meantime.
+     *
+     * The handlers are invoked in the order of their due times, as if invoke() was called for each of the skipped
+     * invocation periods, e.g. a periodic handler is invoked once for each of its periods which has passed. The ticks
+     * without any due handler are skipped without being processed one by one.
+     *
+     * \param[in] elapsed The time passed since the last call to invoke(). MUST BE a multiply of the invocation period.
+     *                    The TimeUnit overload accepts any non-negative time, so it can't overflow.
+     */
+    void invoke(unsigned elapsed);
+    void invoke(TimeUnit elapsed);
+
+    //! Returns the time passed since the manager was constructed, i.e. the number of ticks times the invocation period.
+    TimeUnit now() const;
+
+    /**
+     * \brief Returns the time left until the earliest registered handler is due.
+     *
+     * Allows to sleep exactly until the next handler must be invoked and then call invoke(elapsed). Returns nothing
+     * when there are no handlers registered.
+     */
+    std::optional<TimeUnit> next_deadline() const;
+
     /**
      * \brief Register a handler which will be called with a period or a delay.
      *
@@ -43,15 +236,129 @@ template <unsigned InvocationPeriod> class delayed_work_manager
      *                           delayed_work_policy::keep if you want to keep this handler registered and invoke it
      *                           periodically or it can be equal to delayed_work_policy::deregister if you want to
      *                           invoke the handler finite number of times.
+     * \returns A handle to the job. It refers to no job when the manager has a fixed capacity and it is full.
      */
-    void register_work(unsigned calling_period, std::function<delayed_work_policy(void)> handler);
+    work_handle register_work(unsigned calling_period, delayed_work_handler handler);
+    work_handle register_work(TimeUnit calling_period, delayed_work_handler handler);
+
+    /**
+     * \brief Registers a handler like register_work(), but can be called from any thread.
+     *
+     * The job is registered at the beginning of the next call to invoke(), as if register_work() was called right
+     * before it, thus the period is counted from then. When the manager has a fixed capacity and it is full at that
+     * moment, the job is dropped, like the job refused by register_work(), so it doesn't hold back the jobs submitted
+     * after it.
+     *
+     * The job gets its slot only when it is registered, so no work_handle can be returned and the submitted job can't
+     * be cancelled from outside. The handler may still deregister itself by returning delayed_work_policy::deregister.
+     *
+     * \returns false when the submission queue is full, and then the handler is dropped.
+     */
+    bool submit_work(unsigned calling_period, delayed_work_handler handler);
+    bool submit_work(TimeUnit calling_period, delayed_work_handler handler);
+
+    //! Returns the statistics of the ticks. Needs the instrumentation.
+    delayed_work_manager_stats stats() const;
 
   private:
-    //! Contains all the handlers and the corresponding periods.
-    std::list<delayed_work> m_delayed_work_list;
+    static constexpr unsigned wheel_slot_bits = 6;
+    static constexpr unsigned wheel_slots = 1u << wheel_slot_bits;
+    static constexpr unsigned wheel_levels = 4;
+
+    static constexpr job_index no_job = std::numeric_limits<job_index>::max();
+
+    //! The lists are numbered level by level, slot by slot, and the overflow list is the last one.
+    using list_index = uint16_t;
+    static constexpr list_index overflow_list = wheel_levels * wheel_slots;
+    static constexpr list_index num_lists = overflow_list + 1;
+
+    //! A deque doesn't move the jobs when it grows, so a handler can register a new job while it is being invoked.
+    using job_type = std::conditional_t<IsInstrumented, instrumented_delayed_work, delayed_work>;
+    using job_pool = std::conditional_t<Capacity == 0, std::deque<job_type>, std::array<job_type, Capacity>>;
+
+    //! Each of the jobs is either on one of the lists or on the free list.
+    job_pool m_jobs;
+
+    //! The first jobs of the lists: the slots of the wheel and the list of the jobs due later than the wheel covers.
+    std::array<job_index, num_lists> m_lists;
+
+    //! A singly linked list of the unused slots of the pool.
+    job_index m_free;
+
+    //! A bitmap of non-empty slots for each of the levels of the wheel. Allows to find the next due job quickly.
+    std::array<uint64_t, wheel_levels> m_occupied_slots{};
+
+    //! Counts the ticks (invocation periods) passed.
+    uint64_t m_tick_counter;
+
+    static constexpr std::size_t submission_queue_size = SubmissionQueueSize;
+    static_assert(submission_queue_size != 0 && (submission_queue_size & (submission_queue_size - 1)) == 0,
+                  "The submission queue size must be a power of two");
+
+    /**
+     * An entry of the submission queue. The sequence tells whether the entry is free for the submission at the
+     * position equal to the sequence, or holds the job submitted at the position one less than the sequence.
+     */
+    struct submitted_work
+    {
+        std::atomic<std::size_t> m_sequence;
+        delayed_work_handler m_handler;
+        unsigned m_calling_period;
+    };
+
+    //! A bounded multi-producer, single-consumer queue of the jobs submitted with submit_work().
+    std::array<submitted_work, submission_queue_size> m_submitted;
+
+    //! The position of the next submission, claimed by the submitting threads.
+    std::atomic<std::size_t> m_submission_head{0};
+
+    //! The position of the next job to register, used only by the thread calling invoke().
+    std::size_t m_submission_tail{0};
+
+    //! Registers the jobs submitted with submit_work().
+    void register_submitted_work();
+
+    delayed_work_executor m_executor;
+
+    //! A stack of the jobs which handlers have been run by the executor, linked with delayed_work::m_next.
+    std::atomic<job_index> m_completed{no_job};
+
+    //! Passes the handler of the job to the executor. The job is settled when the handler returns.
+    void dispatch(job_index idx);
+
+    //! Applies the policies returned by the handlers run by the executor.
+    void settle_completed_work();
+
+    //! Advances the time by the number of ticks, processing only the ticks in which something happens.
+    void advance(uint64_t ticks);
+
+    //! Advances the time by a single tick and invokes the handlers which are due.
+    void process_tick();
+
+    //! Puts the job, which isn't on any list, to the slot corresponding to its due tick.
+    void schedule(job_index idx);
+
+    //! Reschedules all the jobs from the list, what moves them to lower levels of the wheel when their time comes.
+    void cascade(list_index l);
+
+    void link(list_index l, job_index idx);
+    void unlink(job_index idx);
+
+    //! Returns an unused slot of the pool, or no_job when the pool is full.
+    job_index allocate();
+    void release(job_index idx);
+
+    //! Returns the job referred to by the handle, or nullptr when the job has been deregistered.
+    job_type *find_registered(job_index idx, uint32_t generation);
 
-    //! Counts the time passed.
-    unsigned m_time_counter;
+    //! Invokes the handler and collects the statistics of the invocation.
+    delayed_work_policy invoke_handler(job_type &job);
+    static void record_execution(delayed_work_stats &stats, std::chrono::nanoseconds execution_time);
+
+    //! Returns the number of ticks until a job is due or must be cascaded, or nothing when there are no jobs.
+    std::optional<uint64_t> ticks_to_next_event() const;
+
+    static unsigned first_set_bit(uint64_t v);
 };
 
 //! Defines what to do with the handler after it has been called
@@ -67,47 +374,775 @@ enum class delayed_work_policy
 //! A container to store the handler and all its related data.
 struct delayed_work
 {
-    std::function<delayed_work_policy(void)> m_handler;
-    const unsigned m_calling_period;
-    const unsigned m_start_time;
+    enum class state : uint8_t
+    {
+        //! The slot of the pool is unused.
+        free,
+
+        //! The job is on one of the lists of the wheel.
+        scheduled,
+
+        //! The handler is being invoked.
+        running,
+
+        //! The job has been cancelled while its handler was being invoked.
+        cancelled
+    };
+
+    delayed_work_handler m_handler;
+    unsigned m_calling_period_ticks{0};
+    uint64_t m_due_tick{0};
+
+    //! Incremented each time the slot is freed, so the handles to the previous jobs become invalid.
+    uint32_t m_generation{0};
+
+    //! The neighbours on the list the job is on. Only m_next is used on the free list.
+    uint32_t m_prev{0};
+    uint32_t m_next{0};
+    uint16_t m_list{0};
+    state m_state{state::free};
+
+    //! The result of the handler run by an executor.
+    delayed_work_policy m_policy{delayed_work_policy::keep};
+};
+
+//! A job of an instrumented delayed_work_manager.
+struct instrumented_delayed_work : delayed_work
+{
+    delayed_work_stats m_stats;
+
+    //! The execution time of the handler run by an executor.
+    std::chrono::nanoseconds m_last_execution_time{0};
+};
+
+//! The data of the instrumentation of the delayed_work_manager. Takes no space when the instrumentation is disabled.
+template <bool IsEnabled> struct delayed_work_manager_instrumentation
+{
+};
+
+template <> struct delayed_work_manager_instrumentation<true>
+{
+    delayed_work_manager_stats m_stats;
+
+    //! The tick up to which the current call to invoke() catches up.
+    uint64_t m_caught_up_tick{0};
+
+    //! The time taken by the handlers in the current tick.
+    std::chrono::nanoseconds m_tick_execution_time{0};
+};
+
+template <unsigned InvocationPeriod,
+          std::size_t Capacity,
+          typename TimeUnit,
+          bool IsInstrumented,
+          std::size_t SubmissionQueueSize>
+delayed_work_manager<InvocationPeriod, Capacity, TimeUnit, IsInstrumented, SubmissionQueueSize>::delayed_work_manager(
+    delayed_work_executor executor)
+    : m_free(no_job), m_tick_counter(0), m_executor(std::move(executor))
+{
+    static_assert(Capacity < no_job, "The capacity is too big");
+
+    m_lists.fill(no_job);
+    for (std::size_t i = 0; i < submission_queue_size; ++i)
+        m_submitted[i].m_sequence.store(i, std::memory_order_relaxed);
+    if constexpr (Capacity != 0)
+        for (job_index idx = Capacity; idx-- > 0;)
+            release(idx);
+}
+
+template <unsigned InvocationPeriod,
+          std::size_t Capacity,
+          typename TimeUnit,
+          bool IsInstrumented,
+          std::size_t SubmissionQueueSize>
+void delayed_work_manager<InvocationPeriod, Capacity, TimeUnit, IsInstrumented, SubmissionQueueSize>::invoke()
+{
+    settle_completed_work();
+    register_submitted_work();
+    if constexpr (IsInstrumented)
+        this->m_caught_up_tick = m_tick_counter + 1;
+    process_tick();
+}
+
+template <unsigned InvocationPeriod,
+          std::size_t Capacity,
+          typename TimeUnit,
+          bool IsInstrumented,
+          std::size_t SubmissionQueueSize>
+void delayed_work_manager<InvocationPeriod, Capacity, TimeUnit, IsInstrumented, SubmissionQueueSize>::invoke(
+    unsigned elapsed)
+{
+    // The elapsed time must be a multiply of the invocation period.
+    assert(elapsed % InvocationPeriod == 0);
+
+    advance(elapsed / InvocationPeriod);
+}
+
+template <unsigned InvocationPeriod,
+          std::size_t Capacity,
+          typename TimeUnit,
+          bool IsInstrumented,
+          std::size_t SubmissionQueueSize>
+void delayed_work_manager<InvocationPeriod, Capacity, TimeUnit, IsInstrumented, SubmissionQueueSize>::invoke(
+    TimeUnit elapsed)
+{
+    // The elapsed time must be a multiply of the invocation period.
+    assert(elapsed.count() % InvocationPeriod == 0);
 
-    delayed_work(std::function<delayed_work_policy(void)> handler, unsigned calling_period, unsigned start_time)
-        : m_handler(handler), m_calling_period(calling_period), m_start_time(start_time)
+    // The time never goes back.
+    advance(elapsed.count() > 0 ? static_cast<uint64_t>(elapsed.count()) / InvocationPeriod : 0);
+}
+
+template <unsigned InvocationPeriod,
+          std::size_t Capacity,
+          typename TimeUnit,
+          bool IsInstrumented,
+          std::size_t SubmissionQueueSize>
+void delayed_work_manager<InvocationPeriod, Capacity, TimeUnit, IsInstrumented, SubmissionQueueSize>::advance(
+    uint64_t ticks)
+{
+    settle_completed_work();
+    register_submitted_work();
+    if constexpr (IsInstrumented)
+        this->m_caught_up_tick = m_tick_counter + ticks;
+    for (uint64_t ticks_left{ticks}; ticks_left != 0;)
     {
+        // Nothing happens until the next event, so the ticks before can be skipped at once.
+        auto ticks_to_event{ticks_to_next_event()};
+        if (!ticks_to_event || *ticks_to_event > ticks_left)
+        {
+            m_tick_counter += ticks_left;
+            return;
+        }
+        m_tick_counter += *ticks_to_event - 1;
+        process_tick();
+        ticks_left -= *ticks_to_event;
     }
-};
+}
+
+template <unsigned InvocationPeriod,
+          std::size_t Capacity,
+          typename TimeUnit,
+          bool IsInstrumented,
+          std::size_t SubmissionQueueSize>
+TimeUnit delayed_work_manager<InvocationPeriod, Capacity, TimeUnit, IsInstrumented, SubmissionQueueSize>::now() const
+{
+    return TimeUnit{static_cast<typename TimeUnit::rep>(m_tick_counter * InvocationPeriod)};
+}
 
-template <unsigned InvocationPeriod> delayed_work_manager<InvocationPeriod>::delayed_work_manager() : m_time_counter(0)
+template <unsigned InvocationPeriod,
+          std::size_t Capacity,
+          typename TimeUnit,
+          bool IsInstrumented,
+          std::size_t SubmissionQueueSize>
+std::optional<TimeUnit>
+delayed_work_manager<InvocationPeriod, Capacity, TimeUnit, IsInstrumented, SubmissionQueueSize>::next_deadline() const
 {
+    auto to_time{[](uint64_t ticks) {
+        return TimeUnit{static_cast<typename TimeUnit::rep>(ticks * InvocationPeriod)};
+    }};
+
+    // All the jobs on a level are due later than the jobs on the levels below, so the earliest job is on the lowest
+    // non-empty level, in its first non-empty slot.
+    if (m_occupied_slots[0] != 0)
+    {
+        auto slot{first_set_bit(m_occupied_slots[0])};
+        return to_time(slot - (m_tick_counter & (wheel_slots - 1)));
+    }
+
+    auto earliest_in{[this, &to_time](unsigned l) {
+        auto res{std::numeric_limits<uint64_t>::max()};
+        for (auto idx{m_lists[l]}; idx != no_job; idx = m_jobs[idx].m_next)
+            res = std::min(res, m_jobs[idx].m_due_tick - m_tick_counter);
+        return to_time(res);
+    }};
+
+    for (unsigned level = 1; level < wheel_levels; ++level)
+        if (m_occupied_slots[level] != 0)
+            return earliest_in(level * wheel_slots + first_set_bit(m_occupied_slots[level]));
+
+    if (m_lists[overflow_list] != no_job)
+        return earliest_in(overflow_list);
+
+    return {};
 }
 
-template <unsigned InvocationPeriod> void delayed_work_manager<InvocationPeriod>::invoke()
+template <unsigned InvocationPeriod,
+          std::size_t Capacity,
+          typename TimeUnit,
+          bool IsInstrumented,
+          std::size_t SubmissionQueueSize>
+void delayed_work_manager<InvocationPeriod, Capacity, TimeUnit, IsInstrumented, SubmissionQueueSize>::process_tick()
 {
-    m_time_counter += InvocationPeriod;
-    for (auto it = m_delayed_work_list.begin(); it != m_delayed_work_list.end();)
+    auto now{++m_tick_counter};
+    if constexpr (IsInstrumented)
+        this->m_tick_execution_time = {};
+
+    // Move the jobs, which are due within the span which begins now, to the lower levels. Start from the highest
+    // level, so the jobs can fall through multiple levels.
+    if ((now & ((1u << (wheel_slot_bits * wheel_levels)) - 1)) == 0)
+        cascade(overflow_list);
+    for (unsigned level = wheel_levels - 1; level > 0; --level)
     {
-        if (((m_time_counter - it->m_start_time) % it->m_calling_period) == 0)
+        if ((now & ((1u << (wheel_slot_bits * level)) - 1)) != 0)
+            continue;
+        auto slot{(now >> (wheel_slot_bits * level)) & (wheel_slots - 1)};
+        cascade(static_cast<list_index>(level * wheel_slots + slot));
+    }
+
+    // All the jobs on the current slot of the level 0 are due now. The jobs rescheduled or registered by the handlers
+    // are due later, so they never land on this slot again.
+    auto slot{static_cast<list_index>(now & (wheel_slots - 1))};
+    for (auto idx{m_lists[slot]}; idx != no_job; idx = m_lists[slot])
+    {
+        unlink(idx);
+        auto &job{m_jobs[idx]};
+        job.m_state = delayed_work::state::running;
+        if constexpr (IsInstrumented)
+        {
+            auto lateness{this->m_caught_up_tick - now};
+            job.m_stats.total_lateness_ticks += lateness;
+            job.m_stats.max_lateness_ticks = std::max(job.m_stats.max_lateness_ticks, lateness);
+        }
+        if (m_executor)
         {
-            if (it->m_handler() == delayed_work_policy::deregister)
-            {
-                it = m_delayed_work_list.erase(it);
-                continue;
-            }
+            dispatch(idx);
+            continue;
         }
-        ++it;
+        auto policy{invoke_handler(job)};
+        if (policy == delayed_work_policy::deregister || job.m_state == delayed_work::state::cancelled)
+        {
+            release(idx);
+            continue;
+        }
+        job.m_due_tick = now + job.m_calling_period_ticks;
+        schedule(idx);
+    }
+
+    if constexpr (IsInstrumented)
+    {
+        auto &stats{this->m_stats};
+        auto tick_execution_time{this->m_tick_execution_time};
+        ++stats.num_ticks;
+        stats.max_tick_execution_time = std::max(stats.max_tick_execution_time, tick_execution_time);
+        if (tick_execution_time > std::chrono::duration_cast<std::chrono::nanoseconds>(TimeUnit{InvocationPeriod}))
+            ++stats.num_overrun_ticks;
     }
 }
 
-template <unsigned InvocationPeriod>
-void delayed_work_manager<InvocationPeriod>::register_work(unsigned calling_period,
-                                                           std::function<delayed_work_policy(void)> handler)
+template <unsigned InvocationPeriod,
+          std::size_t Capacity,
+          typename TimeUnit,
+          bool IsInstrumented,
+          std::size_t SubmissionQueueSize>
+delayed_work_policy
+delayed_work_manager<InvocationPeriod, Capacity, TimeUnit, IsInstrumented, SubmissionQueueSize>::invoke_handler(
+    job_type &job)
+{
+    if constexpr (IsInstrumented)
+    {
+        auto start{std::chrono::steady_clock::now()};
+        auto policy{job.m_handler()};
+        auto execution_time{std::chrono::steady_clock::now() - start};
+        record_execution(job.m_stats, execution_time);
+        this->m_tick_execution_time += execution_time;
+        return policy;
+    }
+    else
+    {
+        return job.m_handler();
+    }
+}
+
+template <unsigned InvocationPeriod,
+          std::size_t Capacity,
+          typename TimeUnit,
+          bool IsInstrumented,
+          std::size_t SubmissionQueueSize>
+void delayed_work_manager<InvocationPeriod, Capacity, TimeUnit, IsInstrumented, SubmissionQueueSize>::record_execution(
+    delayed_work_stats &stats, std::chrono::nanoseconds execution_time)
+{
+    ++stats.num_invocations;
+    stats.max_execution_time = std::max(stats.max_execution_time, execution_time);
+
+    auto us{std::chrono::duration_cast<std::chrono::microseconds>(execution_time).count()};
+    std::size_t bucket{0};
+    for (; us > 0 && bucket < delayed_work_stats::num_histogram_buckets - 1; us >>= 1)
+        ++bucket;
+    ++stats.execution_time_histogram[bucket];
+}
+
+template <unsigned InvocationPeriod,
+          std::size_t Capacity,
+          typename TimeUnit,
+          bool IsInstrumented,
+          std::size_t SubmissionQueueSize>
+typename delayed_work_manager<InvocationPeriod, Capacity, TimeUnit, IsInstrumented, SubmissionQueueSize>::work_handle
+delayed_work_manager<InvocationPeriod, Capacity, TimeUnit, IsInstrumented, SubmissionQueueSize>::register_work(
+    unsigned calling_period, delayed_work_handler handler)
+{
+    assert(calling_period != 0);
+
+    // The calling period must be a multiply of the invocation period.
+    assert(calling_period % InvocationPeriod == 0);
+
+    auto idx{allocate()};
+    if (idx == no_job)
+        return {};
+
+    auto calling_period_ticks{calling_period / InvocationPeriod};
+    auto &job{m_jobs[idx]};
+    job.m_handler = std::move(handler);
+    job.m_calling_period_ticks = calling_period_ticks;
+    job.m_due_tick = m_tick_counter + calling_period_ticks;
+    schedule(idx);
+    return {this, idx, job.m_generation};
+}
+
+template <unsigned InvocationPeriod,
+          std::size_t Capacity,
+          typename TimeUnit,
+          bool IsInstrumented,
+          std::size_t SubmissionQueueSize>
+typename delayed_work_manager<InvocationPeriod, Capacity, TimeUnit, IsInstrumented, SubmissionQueueSize>::work_handle
+delayed_work_manager<InvocationPeriod, Capacity, TimeUnit, IsInstrumented, SubmissionQueueSize>::register_work(
+    TimeUnit calling_period, delayed_work_handler handler)
+{
+    assert(calling_period.count() > 0 && calling_period.count() <= std::numeric_limits<unsigned>::max());
+    return register_work(static_cast<unsigned>(calling_period.count()), std::move(handler));
+}
+
+template <unsigned InvocationPeriod,
+          std::size_t Capacity,
+          typename TimeUnit,
+          bool IsInstrumented,
+          std::size_t SubmissionQueueSize>
+bool delayed_work_manager<InvocationPeriod, Capacity, TimeUnit, IsInstrumented, SubmissionQueueSize>::submit_work(
+    unsigned calling_period, delayed_work_handler handler)
 {
     assert(calling_period != 0);
 
     // The calling period must be a multiply of the invocation period.
     assert(calling_period % InvocationPeriod == 0);
 
-    m_delayed_work_list.emplace_back(handler, calling_period, m_time_counter);
+    // Claim the position of the entry, which is free once the job submitted a queue size earlier has been registered.
+    auto pos{m_submission_head.load(std::memory_order_relaxed)};
+    submitted_work *w;
+    while (true)
+    {
+        w = &m_submitted[pos & (submission_queue_size - 1)];
+        auto sequence{w->m_sequence.load(std::memory_order_acquire)};
+        auto diff{static_cast<std::ptrdiff_t>(sequence - pos)};
+        if (diff == 0)
+        {
+            if (m_submission_head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                break;
+        }
+        else if (diff < 0)
+        {
+            return false;
+        }
+        else
+        {
+            pos = m_submission_head.load(std::memory_order_relaxed);
+        }
+    }
+
+    w->m_handler = std::move(handler);
+    w->m_calling_period = calling_period;
+    w->m_sequence.store(pos + 1, std::memory_order_release);
+    return true;
+}
+
+template <unsigned InvocationPeriod,
+          std::size_t Capacity,
+          typename TimeUnit,
+          bool IsInstrumented,
+          std::size_t SubmissionQueueSize>
+bool delayed_work_manager<InvocationPeriod, Capacity, TimeUnit, IsInstrumented, SubmissionQueueSize>::submit_work(
+    TimeUnit calling_period, delayed_work_handler handler)
+{
+    assert(calling_period.count() > 0 && calling_period.count() <= std::numeric_limits<unsigned>::max());
+    return submit_work(static_cast<unsigned>(calling_period.count()), std::move(handler));
+}
+
+template <unsigned InvocationPeriod,
+          std::size_t Capacity,
+          typename TimeUnit,
+          bool IsInstrumented,
+          std::size_t SubmissionQueueSize>
+void
+delayed_work_manager<InvocationPeriod, Capacity, TimeUnit, IsInstrumented, SubmissionQueueSize>::register_submitted_work()
+{
+    // The jobs are registered in the submission order. A job, which position has been claimed, but which hasn't been
+    // written yet, is left for the next call, so the submitting threads are never waited for. register_work() drops
+    // the job when the pool is full, so the queue is drained anyway.
+    while (true)
+    {
+        auto pos{m_submission_tail};
+        auto &w{m_submitted[pos & (submission_queue_size - 1)]};
+        if (w.m_sequence.load(std::memory_order_acquire) != pos + 1)
+            break;
+        register_work(w.m_calling_period, std::move(w.m_handler));
+        w.m_sequence.store(pos + submission_queue_size, std::memory_order_release);
+        m_submission_tail = pos + 1;
+    }
+}
+
+template <unsigned InvocationPeriod,
+          std::size_t Capacity,
+          typename TimeUnit,
+          bool IsInstrumented,
+          std::size_t SubmissionQueueSize>
+void delayed_work_manager<InvocationPeriod, Capacity, TimeUnit, IsInstrumented, SubmissionQueueSize>::dispatch(
+    job_index idx)
+{
+    // The executor accesses the job only through the pointer, as the pool may grow concurrently. Until the job is
+    // settled, only the executor writes its m_policy, m_next and m_last_execution_time.
+    m_executor([this, idx, job = &m_jobs[idx]]() {
+        if constexpr (IsInstrumented)
+        {
+            auto start{std::chrono::steady_clock::now()};
+            job->m_policy = job->m_handler();
+            job->m_last_execution_time = std::chrono::steady_clock::now() - start;
+        }
+        else
+        {
+            job->m_policy = job->m_handler();
+        }
+        job->m_next = m_completed.load(std::memory_order_relaxed);
+        while (!m_completed.compare_exchange_weak(job->m_next, idx, std::memory_order_release,
+                                                  std::memory_order_relaxed))
+            ;
+    });
+}
+
+template <unsigned InvocationPeriod,
+          std::size_t Capacity,
+          typename TimeUnit,
+          bool IsInstrumented,
+          std::size_t SubmissionQueueSize>
+void
+delayed_work_manager<InvocationPeriod, Capacity, TimeUnit, IsInstrumented, SubmissionQueueSize>::settle_completed_work()
+{
+    for (auto idx{m_completed.exchange(no_job, std::memory_order_acquire)}; idx != no_job;)
+    {
+        auto &job{m_jobs[idx]};
+        auto next{job.m_next};
+        if constexpr (IsInstrumented)
+            record_execution(job.m_stats, job.m_last_execution_time);
+        if (job.m_policy == delayed_work_policy::deregister || job.m_state == delayed_work::state::cancelled)
+        {
+            release(idx);
+        }
+        else
+        {
+            // The job is due a period after it was last due, unless that moment has already passed.
+            auto due{job.m_due_tick + job.m_calling_period_ticks};
+            job.m_due_tick = due <= m_tick_counter ? m_tick_counter + 1 : due;
+            schedule(idx);
+        }
+        idx = next;
+    }
+}
+
+template <unsigned InvocationPeriod,
+          std::size_t Capacity,
+          typename TimeUnit,
+          bool IsInstrumented,
+          std::size_t SubmissionQueueSize>
+bool
+delayed_work_manager<InvocationPeriod, Capacity, TimeUnit, IsInstrumented, SubmissionQueueSize>::work_handle::cancel()
+{
+    auto job{m_manager ? m_manager->find_registered(m_index, m_generation) : nullptr};
+    if (!job)
+        return false;
+
+    // The job which is being invoked is released after its handler returns.
+    if (job->m_state == delayed_work::state::running)
+    {
+        job->m_state = delayed_work::state::cancelled;
+        return true;
+    }
+    m_manager->unlink(m_index);
+    m_manager->release(m_index);
+    return true;
+}
+
+template <unsigned InvocationPeriod,
+          std::size_t Capacity,
+          typename TimeUnit,
+          bool IsInstrumented,
+          std::size_t SubmissionQueueSize>
+bool
+delayed_work_manager<InvocationPeriod, Capacity, TimeUnit, IsInstrumented, SubmissionQueueSize>::work_handle::reschedule(
+    unsigned new_period)
+{
+    assert(new_period != 0);
+
+    // The period must be a multiply of the invocation period.
+    assert(new_period % InvocationPeriod == 0);
+
+    auto job{m_manager ? m_manager->find_registered(m_index, m_generation) : nullptr};
+    if (!job)
+        return false;
+
+    job->m_calling_period_ticks = new_period / InvocationPeriod;
+
+    // The job which is being invoked is rescheduled with the new period after its handler returns.
+    if (job->m_state == delayed_work::state::scheduled)
+    {
+        m_manager->unlink(m_index);
+        job->m_due_tick = m_manager->m_tick_counter + job->m_calling_period_ticks;
+        m_manager->schedule(m_index);
+    }
+    return true;
+}
+
+template <unsigned InvocationPeriod,
+          std::size_t Capacity,
+          typename TimeUnit,
+          bool IsInstrumented,
+          std::size_t SubmissionQueueSize>
+bool
+delayed_work_manager<InvocationPeriod, Capacity, TimeUnit, IsInstrumented, SubmissionQueueSize>::work_handle::reschedule(
+    TimeUnit new_period)
+{
+    assert(new_period.count() > 0 && new_period.count() <= std::numeric_limits<unsigned>::max());
+    return reschedule(static_cast<unsigned>(new_period.count()));
+}
+
+template <unsigned InvocationPeriod,
+          std::size_t Capacity,
+          typename TimeUnit,
+          bool IsInstrumented,
+          std::size_t SubmissionQueueSize>
+bool
+delayed_work_manager<InvocationPeriod, Capacity, TimeUnit, IsInstrumented, SubmissionQueueSize>::work_handle::is_registered() const
+{
+    return m_manager && m_manager->find_registered(m_index, m_generation);
+}
+
+template <unsigned InvocationPeriod,
+          std::size_t Capacity,
+          typename TimeUnit,
+          bool IsInstrumented,
+          std::size_t SubmissionQueueSize>
+std::optional<delayed_work_stats>
+delayed_work_manager<InvocationPeriod, Capacity, TimeUnit, IsInstrumented, SubmissionQueueSize>::work_handle::stats() const
+{
+    static_assert(IsInstrumented, "The statistics are collected only by an instrumented manager");
+
+    auto job{m_manager ? m_manager->find_registered(m_index, m_generation) : nullptr};
+    if (!job)
+        return {};
+    return job->m_stats;
+}
+
+template <unsigned InvocationPeriod,
+          std::size_t Capacity,
+          typename TimeUnit,
+          bool IsInstrumented,
+          std::size_t SubmissionQueueSize>
+delayed_work_manager_stats
+delayed_work_manager<InvocationPeriod, Capacity, TimeUnit, IsInstrumented, SubmissionQueueSize>::stats() const
+{
+    static_assert(IsInstrumented, "The statistics are collected only by an instrumented manager");
+    return this->m_stats;
+}
+
+template <unsigned InvocationPeriod,
+          std::size_t Capacity,
+          typename TimeUnit,
+          bool IsInstrumented,
+          std::size_t SubmissionQueueSize>
+void delayed_work_manager<InvocationPeriod, Capacity, TimeUnit, IsInstrumented, SubmissionQueueSize>::schedule(
+    job_index idx)
+{
+    // The job goes to the lowest level, on which the due tick and the current tick fall within the same slot of the
+    // level above. Thus the job will be cascaded before its slot on the level above is reached again.
+    auto due{m_jobs[idx].m_due_tick};
+    for (unsigned level = 0; level < wheel_levels; ++level)
+    {
+        auto span_bits{wheel_slot_bits * (level + 1)};
+        auto is_within_span{span_bits >= 64 || (due >> span_bits) == (m_tick_counter >> span_bits)};
+        if (is_within_span)
+        {
+            auto slot{(due >> (wheel_slot_bits * level)) & (wheel_slots - 1)};
+            link(static_cast<list_index>(level * wheel_slots + slot), idx);
+            return;
+        }
+    }
+    link(overflow_list, idx);
+}
+
+template <unsigned InvocationPeriod,
+          std::size_t Capacity,
+          typename TimeUnit,
+          bool IsInstrumented,
+          std::size_t SubmissionQueueSize>
+void delayed_work_manager<InvocationPeriod, Capacity, TimeUnit, IsInstrumented, SubmissionQueueSize>::cascade(
+    list_index l)
+{
+    // The list is detached first, because a job due further than the wheel covers goes back to the overflow list.
+    auto idx{std::exchange(m_lists[l], no_job)};
+    if (l != overflow_list)
+        m_occupied_slots[l / wheel_slots] &= ~(uint64_t{1} << (l % wheel_slots));
+    while (idx != no_job)
+    {
+        auto next{m_jobs[idx].m_next};
+        schedule(idx);
+        idx = next;
+    }
+}
+
+template <unsigned InvocationPeriod,
+          std::size_t Capacity,
+          typename TimeUnit,
+          bool IsInstrumented,
+          std::size_t SubmissionQueueSize>
+void delayed_work_manager<InvocationPeriod, Capacity, TimeUnit, IsInstrumented, SubmissionQueueSize>::link(
+    list_index l, job_index idx)
+{
+    auto &job{m_jobs[idx]};
+    job.m_state = delayed_work::state::scheduled;
+    job.m_list = l;
+    job.m_prev = no_job;
+    job.m_next = m_lists[l];
+    if (job.m_next != no_job)
+        m_jobs[job.m_next].m_prev = idx;
+    m_lists[l] = idx;
+
+    if (l != overflow_list)
+        m_occupied_slots[l / wheel_slots] |= uint64_t{1} << (l % wheel_slots);
+}
+
+template <unsigned InvocationPeriod,
+          std::size_t Capacity,
+          typename TimeUnit,
+          bool IsInstrumented,
+          std::size_t SubmissionQueueSize>
+void delayed_work_manager<InvocationPeriod, Capacity, TimeUnit, IsInstrumented, SubmissionQueueSize>::unlink(
+    job_index idx)
+{
+    auto &job{m_jobs[idx]};
+    if (job.m_next != no_job)
+        m_jobs[job.m_next].m_prev = job.m_prev;
+    if (job.m_prev != no_job)
+    {
+        m_jobs[job.m_prev].m_next = job.m_next;
+        return;
+    }
+
+    // The job was the first one on the list.
+    m_lists[job.m_list] = job.m_next;
+    if (job.m_next == no_job && job.m_list != overflow_list)
+        m_occupied_slots[job.m_list / wheel_slots] &= ~(uint64_t{1} << (job.m_list % wheel_slots));
+}
+
+template <unsigned InvocationPeriod,
+          std::size_t Capacity,
+          typename TimeUnit,
+          bool IsInstrumented,
+          std::size_t SubmissionQueueSize>
+typename delayed_work_manager<InvocationPeriod, Capacity, TimeUnit, IsInstrumented, SubmissionQueueSize>::job_index
+delayed_work_manager<InvocationPeriod, Capacity, TimeUnit, IsInstrumented, SubmissionQueueSize>::allocate()
+{
+    if (m_free != no_job)
+    {
+        auto idx{m_free};
+        m_free = m_jobs[idx].m_next;
+        return idx;
+    }
+
+    if constexpr (Capacity == 0)
+    {
+        assert(m_jobs.size() < no_job);
+        m_jobs.emplace_back();
+        return static_cast<job_index>(m_jobs.size() - 1);
+    }
+    else
+    {
+        return no_job;
+    }
+}
+
+template <unsigned InvocationPeriod,
+          std::size_t Capacity,
+          typename TimeUnit,
+          bool IsInstrumented,
+          std::size_t SubmissionQueueSize>
+void delayed_work_manager<InvocationPeriod, Capacity, TimeUnit, IsInstrumented, SubmissionQueueSize>::release(
+    job_index idx)
+{
+    auto &job{m_jobs[idx]};
+    job.m_handler = nullptr;
+    job.m_state = delayed_work::state::free;
+    ++job.m_generation;
+    job.m_next = m_free;
+    m_free = idx;
+}
+
+template <unsigned InvocationPeriod,
+          std::size_t Capacity,
+          typename TimeUnit,
+          bool IsInstrumented,
+          std::size_t SubmissionQueueSize>
+typename delayed_work_manager<InvocationPeriod, Capacity, TimeUnit, IsInstrumented, SubmissionQueueSize>::job_type *
+delayed_work_manager<InvocationPeriod, Capacity, TimeUnit, IsInstrumented, SubmissionQueueSize>::find_registered(
+    job_index idx, uint32_t generation)
+{
+    auto &job{m_jobs[idx]};
+    auto is_registered{job.m_state == delayed_work::state::scheduled || job.m_state == delayed_work::state::running};
+    return job.m_generation == generation && is_registered ? &job : nullptr;
+}
+
+template <unsigned InvocationPeriod,
+          std::size_t Capacity,
+          typename TimeUnit,
+          bool IsInstrumented,
+          std::size_t SubmissionQueueSize>
+std::optional<uint64_t>
+delayed_work_manager<InvocationPeriod, Capacity, TimeUnit, IsInstrumented, SubmissionQueueSize>::ticks_to_next_event() const
+{
+    // The jobs on the level 0 are due on their slot. The jobs on the higher levels are cascaded when the time reaches
+    // the beginning of their slot. The occupied slots are always ahead of the current slot on their level.
+    for (unsigned level = 0; level < wheel_levels; ++level)
+    {
+        if (m_occupied_slots[level] == 0)
+            continue;
+        auto slot_bits{wheel_slot_bits * level};
+        auto span_bits{slot_bits + wheel_slot_bits};
+        auto span_begin{(m_tick_counter >> span_bits) << span_bits};
+        return span_begin + (first_set_bit(m_occupied_slots[level]) << slot_bits) - m_tick_counter;
+    }
+
+    // The overflow list is checked when the time reaches the end of the whole wheel.
+    if (m_lists[overflow_list] != no_job)
+    {
+        auto wheel_bits{wheel_slot_bits * wheel_levels};
+        return (((m_tick_counter >> wheel_bits) + 1) << wheel_bits) - m_tick_counter;
+    }
+
+    return {};
+}
+
+template <unsigned InvocationPeriod,
+          std::size_t Capacity,
+          typename TimeUnit,
+          bool IsInstrumented,
+          std::size_t SubmissionQueueSize>
+unsigned delayed_work_manager<InvocationPeriod, Capacity, TimeUnit, IsInstrumented, SubmissionQueueSize>::first_set_bit(
+    uint64_t v)
+{
+#if defined(__GNUC__)
+    return static_cast<unsigned>(__builtin_ctzll(v));
+#else
+    unsigned res = 0;
+    for (; (v & 1) == 0; v >>= 1)
+        ++res;
+    return res;
+#endif
 }
 
 #endif /* DELAYED_WORK_MANAGER_HPP */
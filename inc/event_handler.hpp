@@ -7,8 +7,12 @@
 #ifndef EVENT_HANDLER_HPP
 #define EVENT_HANDLER_HPP
 
-#include <functional>
-#include <list>
+#include "inplace_function.hpp"
+
+#include <array>
+#include <cstdint>
+#include <iterator>
+#include <vector>
 
 namespace jungles {
 
@@ -23,9 +27,27 @@ namespace jungles {
  * Use this class when you want to expose some event like pushing a button or scheduled wake up in the system.
  * When the event occurs then call the function raise() it will call all the registered handlers.
  * The handlers must return policy which tells the event handler whether to keep the handler or to deregister the
- * handler. This allows to control when should be the handler be deregistered.
+ * handler. This allows to control when should be the handler be deregistered. A handler can also be deregistered at
+ * any time, with the token returned by register_handler().
+ *
+ * The event may carry a payload: the Args are the types of the arguments of raise(). The arguments are passed to each
+ * of the handlers by lvalue reference, so they are never copied and a handler may modify them for the handlers which
+ * follow. Use const types to pass a read-only payload, e.g. basic_event_handler<const frame&>.
+ *
+ * The handlers are invoked by their priority, from critical to low, and in the order of registration within the
+ * same priority.
+ *
+ * The handlers are stored in jungles::inplace_function, so the callable doesn't allocate. Its size is limited by
+ * JUNGLES_INPLACE_FUNCTION_DEFAULT_CAPACITY.
+ *
+ * Each priority keeps its handlers contiguously in a vector, in the order of registration, so raise() walks the
+ * handlers without any indirection. A token refers to an entry of a separate table, which tells where its handler is,
+ * so deregistration is O(1). A deregistered handler stays in the vector (a tombstone) and is skipped, and all the
+ * tombstones are removed at once when raise() ends, or when they outnumber the registered handlers. The handlers
+ * registered by the handlers, while raise() runs, are kept aside and appended to the vectors when raise() ends, so
+ * the vectors don't reallocate while the handlers are invoked. They are first invoked by the next raise().
  */
-class event_handler
+template <typename... Args> class basic_event_handler
 {
   public:
     enum policy
@@ -34,30 +56,223 @@ class event_handler
         deregister
     };
 
-    void raise();
-    void register_handler(std::function<policy(void)> handler);
+    enum priority
+    {
+        critical,
+        high,
+        normal,
+        low,
+        num_priorities
+    };
+
+    using handler_type = inplace_function<policy(Args &...)>;
+
+    //! Identifies a registered handler. Becomes stale when the handler is deregistered.
+    struct token
+    {
+        std::uint32_t id;
+        std::uint32_t generation;
+    };
+
+    //! Takes anything what binds to Args&, temporaries as well, as they live until raise() returns.
+    template <typename... Ts> void raise(Ts &&...args);
+    token register_handler(handler_type handler, priority prio = priority::normal);
+
+    /**
+     * \brief Deregisters the handler in O(1). Can be called from the handlers.
+     * \returns False when the handler has been deregistered already.
+     */
+    bool deregister_handler(token t);
 
   private:
-    std::list<std::function<policy(void)>> m_handlers;
+    struct slot
+    {
+        handler_type handler;
+        std::uint32_t id;
+        bool is_registered;
+    };
+
+    //! Tells where the handler of a token is: at the index in the vector of the priority or in m_pending.
+    struct location
+    {
+        std::uint32_t generation{0};
+        std::uint32_t index{0};
+        priority prio{priority::normal};
+        bool is_pending{false};
+    };
+
+    struct pending_slot
+    {
+        priority prio;
+        slot s;
+    };
+
+    //! Decrements the depth even when a handler throws, so the later calls to raise() compact the handlers.
+    struct raise_depth_guard
+    {
+        unsigned &depth;
+
+        explicit raise_depth_guard(unsigned &d) : depth{d}
+        {
+            ++depth;
+        }
+
+        ~raise_depth_guard()
+        {
+            --depth;
+        }
+    };
+
+    std::array<std::vector<slot>, num_priorities> m_slots;
+
+    //! The handlers registered while raise() runs.
+    std::vector<pending_slot> m_pending;
+
+    //! Indexed with the token id.
+    std::vector<location> m_locations;
+    std::vector<std::uint32_t> m_free_ids;
+
+    std::size_t m_num_registered{0};
+    std::size_t m_num_tombstones{0};
+
+    //! Greater than 1 when raise() is called from a handler.
+    unsigned m_raise_depth{0};
+
+    slot &find(const location &l);
+    void make_tombstone(slot &s);
+
+    //! Removes the tombstones, appends the pending handlers and frees the ids of the removed handlers.
+    void compact();
 };
 
+//! The event without a payload.
+using event_handler = basic_event_handler<>;
+
 // --------------------------------------------------------------------------------------------------------------------
 // DEFINITIONS OF PUBLIC STUFF
 // --------------------------------------------------------------------------------------------------------------------
-void event_handler::raise()
+template <typename... Args> template <typename... Ts> void basic_event_handler<Args...>::raise(Ts &&...args)
+{
+    static_assert(sizeof...(Ts) == sizeof...(Args), "raise() must be given one argument for each of the Args");
+
+    {
+        raise_depth_guard guard{m_raise_depth};
+        // The vectors don't change while raise() runs, as the handlers registered meanwhile are pending.
+        for (auto &slots : m_slots)
+        {
+            for (auto &s : slots)
+            {
+                if (!s.is_registered)
+                    continue;
+                // The handler might have deregistered itself with its token.
+                if (s.handler(args...) == policy::deregister && s.is_registered)
+                    make_tombstone(s);
+            }
+        }
+    }
+    if (m_raise_depth == 0)
+        compact();
+}
+
+template <typename... Args>
+typename basic_event_handler<Args...>::token basic_event_handler<Args...>::register_handler(handler_type handler,
+                                                                                         priority prio)
 {
-    for (auto it = m_handlers.begin(); it != m_handlers.end();)
+    std::uint32_t id;
+    if (!m_free_ids.empty())
     {
-        if ((*it)() == policy::deregister)
-            it = m_handlers.erase(it);
-        else
-            it++;
+        id = m_free_ids.back();
+        m_free_ids.pop_back();
     }
+    else
+    {
+        id = static_cast<std::uint32_t>(m_locations.size());
+        m_locations.emplace_back();
+    }
+
+    auto &l{m_locations[id]};
+    l.prio = prio;
+    l.is_pending = m_raise_depth != 0;
+    if (l.is_pending)
+    {
+        l.index = static_cast<std::uint32_t>(m_pending.size());
+        m_pending.push_back({prio, slot{std::move(handler), id, true}});
+    }
+    else
+    {
+        l.index = static_cast<std::uint32_t>(m_slots[prio].size());
+        m_slots[prio].push_back(slot{std::move(handler), id, true});
+    }
+    ++m_num_registered;
+    return {id, l.generation};
+}
+
+template <typename... Args> bool basic_event_handler<Args...>::deregister_handler(token t)
+{
+    if (t.id >= m_locations.size() || m_locations[t.id].generation != t.generation)
+        return false;
+    make_tombstone(find(m_locations[t.id]));
+    // Keeps the memory bounded when the handlers are registered and deregistered without raising the event.
+    if (m_raise_depth == 0 && m_num_tombstones > m_num_registered)
+        compact();
+    return true;
+}
+
+// --------------------------------------------------------------------------------------------------------------------
+// DEFINITIONS OF PRIVATE STUFF
+// --------------------------------------------------------------------------------------------------------------------
+template <typename... Args>
+typename basic_event_handler<Args...>::slot &basic_event_handler<Args...>::find(const location &l)
+{
+    return l.is_pending ? m_pending[l.index].s : m_slots[l.prio][l.index];
+}
+
+template <typename... Args> void basic_event_handler<Args...>::make_tombstone(slot &s)
+{
+    // The handler is not destroyed here, as it might be running. The id is freed when the tombstone is removed.
+    s.is_registered = false;
+    ++m_locations[s.id].generation;
+    --m_num_registered;
+    ++m_num_tombstones;
 }
 
-void event_handler::register_handler(std::function<policy(void)> handler)
+template <typename... Args> void basic_event_handler<Args...>::compact()
 {
-    m_handlers.emplace_back(std::move(handler));
+    if (m_num_tombstones == 0 && m_pending.empty())
+        return;
+
+    for (auto &slots : m_slots)
+    {
+        std::size_t num_kept{0};
+        for (auto &s : slots)
+        {
+            if (!s.is_registered)
+            {
+                m_free_ids.push_back(s.id);
+                continue;
+            }
+            m_locations[s.id].index = static_cast<std::uint32_t>(num_kept);
+            if (&slots[num_kept] != &s)
+                slots[num_kept] = std::move(s);
+            ++num_kept;
+        }
+        slots.erase(std::next(std::begin(slots), num_kept), std::end(slots));
+    }
+
+    for (auto &p : m_pending)
+    {
+        if (!p.s.is_registered)
+        {
+            m_free_ids.push_back(p.s.id);
+            continue;
+        }
+        auto &l{m_locations[p.s.id]};
+        l.is_pending = false;
+        l.index = static_cast<std::uint32_t>(m_slots[p.prio].size());
+        m_slots[p.prio].push_back(std::move(p.s));
+    }
+    m_pending.clear();
+    m_num_tombstones = 0;
 }
 
 } // namespace jungles
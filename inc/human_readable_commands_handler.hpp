@@ -38,12 +38,31 @@ template <size_t N> class human_readable_commands_handler
 	//! Returns the oldest command.
 	std::string pop_command() noexcept;
 
+	/**
+	 * \brief Pops the oldest command into s, reusing the capacity of s, thus popping doesn't allocate once s is big
+	 * enough.
+	 * \returns False, and leaves s untouched, when there is no command.
+	 */
+	bool pop_string_into(std::string &s);
+
+	/**
+	 * \brief Pops the oldest command into the buffer p of size n. The command is truncated to n - 1 chars and
+	 * null-terminated.
+	 * \returns The length of the popped command, which is not lower than n when the command has been truncated, or
+	 * 0 when there is no command.
+	 */
+	size_t pop_into(char *p, size_t n) noexcept;
+
 	/**
 	 * \brief Pushes an element to the buffer and returns true if the element indicates the end of command.
 	 *
 	 * The end of a command is indicated by '\r' character. '\n' are ignored.
 	 */
 	bool push_elem_and_check_command_end(char c) noexcept;
+
+  private:
+	//! Views the oldest non-empty command, dropping the empty ones. The view is empty when there is no command.
+	cyclic_buf_string_view peek_command() noexcept;
 };
 
 template <size_t N> std::string human_readable_commands_handler<N>::pop_command() noexcept
@@ -76,6 +95,51 @@ template <size_t N> std::string human_readable_commands_handler<N>::pop_command(
 	return s;
 }
 
+template <size_t N> bool human_readable_commands_handler<N>::pop_string_into(std::string &s)
+{
+	auto v = peek_command();
+	if (v.empty())
+		return false;
+
+	v.copy_to(s);
+	cb.tail = end_indexes_cb.pop_elem();
+	return true;
+}
+
+template <size_t N> size_t human_readable_commands_handler<N>::pop_into(char *p, size_t n) noexcept
+{
+	auto v = peek_command();
+	if (v.empty())
+		return 0;
+
+	auto len = v.copy_to(p, n);
+	cb.tail = end_indexes_cb.pop_elem();
+	return len;
+}
+
+template <size_t N> cyclic_buf_string_view human_readable_commands_handler<N>::peek_command() noexcept
+{
+	while (!end_indexes_cb.is_empty())
+	{
+		auto beg = cb.tail;
+		auto end = end_indexes_cb.peek_elem();
+
+		unsigned int len;
+		// Check whether there will be a swing.
+		if (beg > end)
+			len = cb.size - beg + end;
+		else
+			len = end - beg;
+
+		if (len != 0)
+			return cb.peek_nelems(len);
+
+		// The same as pop_command(), the empty commands are skipped.
+		end_indexes_cb.pop_elem();
+	}
+	return {};
+}
+
 template <size_t N> bool human_readable_commands_handler<N>::push_elem_and_check_command_end(char c) noexcept
 {
 	// Ignore the line feed and null terminating character.
@@ -8,7 +8,9 @@
 #define IBYTE_STREAM_OSTRING_STREAM_HPP
 
 #include "cyclic_buf.hpp"
+#include <algorithm>
 #include <array>
+#include <cstring>
 #include <string>
 #include <string_view>
 
@@ -56,12 +58,51 @@ template <size_t InternalBufSize, size_t MaxNumStringsInBuf> class ibytestream_o
      */
     bool push_byte_and_is_string_end(char c);
 
+    /**
+     * Push a chunk of bytes, e.g. read from a socket, as if they were pushed one by one. The terminators are found
+     * with memchr() and the bytes between them are copied to the internal buffer at once.
+     * \returns The number of the strings which have been completed by the chunk.
+     */
+    unsigned push_bytes(std::string_view bytes);
+
     //! Pop a whole string. When there is no string this returns an empty string.
     std::string pop_string();
 
+    /**
+     * View the oldest string in the internal buffer without copying it. The view is split into two parts only when
+     * the string wraps around the end of the buffer. It stays valid until release() is called. When there is no
+     * string this returns an empty view.
+     */
+    cyclic_buf_string_view peek_string() const;
+
+    //! Consume the string returned by peek_string(). Does nothing when there is no string.
+    void release();
+
+    /**
+     * Pop a whole string into s, reusing the capacity of s, thus popping doesn't allocate once s is big enough.
+     * \returns False, and leaves s untouched, when there is no string.
+     */
+    bool pop_string_into(std::string &s);
+
+    /**
+     * Pop a whole string into the buffer p of size n. The string is truncated to n - 1 chars and null-terminated.
+     * \returns The length of the popped string, which is not lower than n when the string has been truncated, or 0
+     * when there is no string.
+     */
+    size_t pop_into(char *p, size_t n);
+
     bool is_empty();
 
   private:
+    enum char_class : unsigned char
+    {
+        terminator = 1,
+        exceptional = 2
+    };
+
+    //! push_bytes() keeps the next position of each of that many terminators, more are looked up in m_char_classes.
+    static constexpr std::size_t max_memchr_terminators{4};
+
     //! This is a helper object which holds the indexes of the commands' ends. @todo Allocator pvPortMalloc
     cyclic_buf<unsigned int, MaxNumStringsInBuf> m_end_indexes_cb;
 
@@ -74,8 +115,14 @@ template <size_t InternalBufSize, size_t MaxNumStringsInBuf> class ibytestream_o
     //! Contains the characters which determine the string end.
     const std::string_view m_string_terminators;
 
+    //! Tells whether a char is a terminator or an exceptional char, indexed with unsigned char.
+    std::array<unsigned char, 256> m_char_classes{};
+
     //! Last head index in the immediate buffer.
     unsigned m_last_end_idx{0};
+
+    bool is_of_class(char c, char_class cls) const;
+    void mark_string_end();
 };
 
 template <size_t InternalBufSize, size_t MaxNumStringsInBuf>
@@ -83,33 +130,35 @@ ibytestream_ostringstream<InternalBufSize, MaxNumStringsInBuf>::ibytestream_ostr
     std::string_view exceptional_chars, std::string_view string_terminators)
     : m_exceptional_chars(exceptional_chars), m_string_terminators(string_terminators)
 {
+    for (auto c : m_exceptional_chars)
+        m_char_classes[static_cast<unsigned char>(c)] |= char_class::exceptional;
+    for (auto c : m_string_terminators)
+        m_char_classes[static_cast<unsigned char>(c)] |= char_class::terminator;
 }
 
 template <size_t InternalBufSize, size_t MaxNumStringsInBuf>
 bool ibytestream_ostringstream<InternalBufSize, MaxNumStringsInBuf>::push_byte_and_is_string_end(char c)
 {
-    if (m_string_terminators.find(c) != std::string::npos)
+    if (is_of_class(c, char_class::terminator))
     {
         // When received a command of length 0 then do nothing.
         if (m_last_end_idx == m_cb.head)
             return false;
         else
         {
-            m_end_indexes_cb.push_elem(m_cb.head);
-            m_last_end_idx = m_cb.head;
+            mark_string_end();
             return true;
         }
     }
 
     // After receiving the exceptional character:
-    if (m_exceptional_chars.find(c) != std::string::npos)
+    if (is_of_class(c, char_class::exceptional))
     {
         // Exceptional characters work only when they are received alone.
         if (m_last_end_idx == m_cb.head)
         {
             m_cb.push_elem(c);
-            m_end_indexes_cb.push_elem(m_cb.head);
-            m_last_end_idx = m_cb.head;
+            mark_string_end();
             return true;
         }
     }
@@ -120,6 +169,79 @@ bool ibytestream_ostringstream<InternalBufSize, MaxNumStringsInBuf>::push_byte_a
     return false;
 }
 
+template <size_t InternalBufSize, size_t MaxNumStringsInBuf>
+unsigned ibytestream_ostringstream<InternalBufSize, MaxNumStringsInBuf>::push_bytes(std::string_view bytes)
+{
+    if (bytes.empty())
+        return 0;
+
+    auto p{bytes.data()};
+    auto const end{bytes.data() + bytes.size()};
+    auto const num_terminators{m_string_terminators.size()};
+    auto const is_memchr_used{num_terminators <= max_memchr_terminators};
+
+    auto memchr_or_end{[&end](const char *from, char c) {
+        auto found{std::memchr(from, c, static_cast<std::size_t>(end - from))};
+        return found ? static_cast<const char *>(found) : end;
+    }};
+
+    // The next occurrence of each of the terminators, searched for again only when passed.
+    std::array<const char *, max_memchr_terminators> next_terminators;
+    if (is_memchr_used)
+        for (std::size_t i = 0; i < num_terminators; ++i)
+            next_terminators[i] = memchr_or_end(p, m_string_terminators[i]);
+
+    auto find_next_terminator{[&]() {
+        if (!is_memchr_used)
+            return std::find_if(p, end, [this](char c) { return is_of_class(c, char_class::terminator); });
+
+        auto nearest{end};
+        for (std::size_t i = 0; i < num_terminators; ++i)
+        {
+            auto &next{next_terminators[i]};
+            if (next < p)
+                next = memchr_or_end(p, m_string_terminators[i]);
+            nearest = std::min(nearest, next);
+        }
+        return nearest;
+    }};
+
+    unsigned num_strings{0};
+    while (p != end)
+    {
+        // Exceptional characters work only when they are received alone.
+        if (m_last_end_idx == m_cb.head && is_of_class(*p, char_class::exceptional) &&
+            !is_of_class(*p, char_class::terminator))
+        {
+            m_cb.push_elem(*p++);
+            mark_string_end();
+            ++num_strings;
+            continue;
+        }
+
+        // A segment longer than the internal buffer overflows it, as pushing it byte by byte would, but push_nelems()
+        // can wrap around the end of the buffer only once, thus the segment is pushed in pieces.
+        auto t{find_next_terminator()};
+        while (p != t)
+        {
+            auto n{std::min(static_cast<std::size_t>(t - p), InternalBufSize)};
+            m_cb.push_nelems(p, static_cast<unsigned>(n));
+            p += n;
+        }
+        if (p == end)
+            break;
+
+        // When received a command of length 0 then do nothing.
+        if (m_last_end_idx != m_cb.head)
+        {
+            mark_string_end();
+            ++num_strings;
+        }
+        ++p;
+    }
+    return num_strings;
+}
+
 template <size_t InternalBufSize, size_t MaxNumStringsInBuf>
 std::string ibytestream_ostringstream<InternalBufSize, MaxNumStringsInBuf>::pop_string()
 {
@@ -138,12 +260,66 @@ std::string ibytestream_ostringstream<InternalBufSize, MaxNumStringsInBuf>::pop_
     return std::move(s);
 }
 
+template <size_t InternalBufSize, size_t MaxNumStringsInBuf>
+cyclic_buf_string_view ibytestream_ostringstream<InternalBufSize, MaxNumStringsInBuf>::peek_string() const
+{
+    if (m_end_indexes_cb.is_empty())
+        return {};
+
+    auto len{detail::calc_len_in_circular_buffer(m_cb.tail, m_end_indexes_cb.peek_elem(), InternalBufSize)};
+    return m_cb.peek_nelems(len);
+}
+
+template <size_t InternalBufSize, size_t MaxNumStringsInBuf>
+void ibytestream_ostringstream<InternalBufSize, MaxNumStringsInBuf>::release()
+{
+    if (is_empty())
+        return;
+
+    m_cb.tail = m_end_indexes_cb.pop_elem();
+}
+
+template <size_t InternalBufSize, size_t MaxNumStringsInBuf>
+bool ibytestream_ostringstream<InternalBufSize, MaxNumStringsInBuf>::pop_string_into(std::string &s)
+{
+    if (is_empty())
+        return false;
+
+    peek_string().copy_to(s);
+    release();
+    return true;
+}
+
+template <size_t InternalBufSize, size_t MaxNumStringsInBuf>
+size_t ibytestream_ostringstream<InternalBufSize, MaxNumStringsInBuf>::pop_into(char *p, size_t n)
+{
+    if (is_empty())
+        return 0;
+
+    auto len{peek_string().copy_to(p, n)};
+    release();
+    return len;
+}
+
 template <size_t InternalBufSize, size_t MaxNumStringsInBuf>
 bool ibytestream_ostringstream<InternalBufSize, MaxNumStringsInBuf>::is_empty()
 {
     return m_end_indexes_cb.is_empty();
 }
 
+template <size_t InternalBufSize, size_t MaxNumStringsInBuf>
+bool ibytestream_ostringstream<InternalBufSize, MaxNumStringsInBuf>::is_of_class(char c, char_class cls) const
+{
+    return m_char_classes[static_cast<unsigned char>(c)] & cls;
+}
+
+template <size_t InternalBufSize, size_t MaxNumStringsInBuf>
+void ibytestream_ostringstream<InternalBufSize, MaxNumStringsInBuf>::mark_string_end()
+{
+    m_end_indexes_cb.push_elem(m_cb.head);
+    m_last_end_idx = m_cb.head;
+}
+
 namespace detail {
 static inline unsigned calc_len_in_circular_buffer(unsigned beg_idx, unsigned end_idx, unsigned cyclic_buf_size)
 {
@@ -0,0 +1,153 @@
+/**
+ * @file	inplace_function.hpp
+ * @brief	Implements a std::function-like wrapper which stores the callable in a fixed-size internal buffer.
+ * @author	Kacper Kowalski - kacper.s.kowalski@gmail.com
+ */
+
+#ifndef INPLACE_FUNCTION_HPP
+#define INPLACE_FUNCTION_HPP
+
+#include <cassert>
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+/**
+ * The default size of the buffer of jungles::inplace_function. Used by the event_handler and delayed_work_manager to
+ * store the handlers. Define it globally to change the default.
+ */
+#ifndef JUNGLES_INPLACE_FUNCTION_DEFAULT_CAPACITY
+#define JUNGLES_INPLACE_FUNCTION_DEFAULT_CAPACITY (4 * sizeof(void *))
+#endif
+
+namespace jungles {
+
+template <typename Signature,
+          std::size_t Capacity = JUNGLES_INPLACE_FUNCTION_DEFAULT_CAPACITY,
+          std::size_t Alignment = alignof(std::max_align_t)>
+class inplace_function;
+
+/**
+ * \brief Stores any copyable callable with the matching signature, like std::function, but never allocates.
+ *
+ * The callable is stored inside the internal buffer of size Capacity. When the callable doesn't fit in the buffer
+ * then the compilation fails, so the capacity can be adjusted. Calling an empty inplace_function is undefined
+ * behaviour.
+ *
+ * \tparam Capacity  The size of the internal buffer.
+ * \tparam Alignment The alignment of the internal buffer.
+ */
+template <typename R, typename... Args, std::size_t Capacity, std::size_t Alignment>
+class inplace_function<R(Args...), Capacity, Alignment>
+{
+  public:
+    inplace_function() noexcept = default;
+
+    inplace_function(std::nullptr_t) noexcept
+    {
+    }
+
+    template <typename F,
+              typename T = std::decay_t<F>,
+              typename = std::enable_if_t<!std::is_same_v<T, inplace_function> &&
+                                          std::is_invocable_r_v<R, T &, Args...>>>
+    inplace_function(F &&f) : m_ops{&ops_for<T>}
+    {
+        static_assert(sizeof(T) <= Capacity, "The callable doesn't fit in the inplace_function: increase the capacity");
+        static_assert(Alignment % alignof(T) == 0, "The callable has alignment incompatible with the inplace_function");
+        static_assert(std::is_copy_constructible_v<T>, "The callable must be copyable");
+        ::new (&m_storage) T(std::forward<F>(f));
+    }
+
+    inplace_function(const inplace_function &other) : m_ops{other.m_ops}
+    {
+        if (m_ops)
+            m_ops->copy(&m_storage, &other.m_storage);
+    }
+
+    inplace_function(inplace_function &&other) noexcept : m_ops{other.m_ops}
+    {
+        if (m_ops)
+            m_ops->move(&m_storage, &other.m_storage);
+        other.m_ops = nullptr;
+    }
+
+    inplace_function &operator=(const inplace_function &other)
+    {
+        if (this != &other)
+        {
+            reset();
+            if (other.m_ops)
+                other.m_ops->copy(&m_storage, &other.m_storage);
+            m_ops = other.m_ops;
+        }
+        return *this;
+    }
+
+    inplace_function &operator=(inplace_function &&other) noexcept
+    {
+        if (this != &other)
+        {
+            reset();
+            if (other.m_ops)
+                other.m_ops->move(&m_storage, &other.m_storage);
+            m_ops = other.m_ops;
+            other.m_ops = nullptr;
+        }
+        return *this;
+    }
+
+    ~inplace_function()
+    {
+        reset();
+    }
+
+    R operator()(Args... args) const
+    {
+        assert(m_ops);
+        return m_ops->invoke(&m_storage, std::forward<Args>(args)...);
+    }
+
+    explicit operator bool() const noexcept
+    {
+        return m_ops != nullptr;
+    }
+
+  private:
+    //! Type-erased operations on the stored callable.
+    struct operations
+    {
+        R (*invoke)(void *, Args &&...);
+        void (*copy)(void *, const void *);
+
+        //! Move-constructs to the destination and destroys the source.
+        void (*move)(void *, void *) noexcept;
+        void (*destroy)(void *) noexcept;
+    };
+
+    template <typename T> static constexpr operations ops_for{
+        [](void *f, Args &&... args) -> R { return (*static_cast<T *>(f))(std::forward<Args>(args)...); },
+        [](void *dst, const void *src) { ::new (dst) T(*static_cast<const T *>(src)); },
+        [](void *dst, void *src) noexcept {
+            ::new (dst) T(std::move(*static_cast<T *>(src)));
+            static_cast<T *>(src)->~T();
+        },
+        [](void *f) noexcept { static_cast<T *>(f)->~T(); }};
+
+    const operations *m_ops{nullptr};
+
+    //! Mutable, because the callable may be mutable, while operator() is const like the one of std::function.
+    alignas(Alignment) mutable std::byte m_storage[Capacity];
+
+    void reset() noexcept
+    {
+        if (m_ops)
+            m_ops->destroy(&m_storage);
+        m_ops = nullptr;
+    }
+};
+
+} // namespace jungles
+
+#endif /* INPLACE_FUNCTION_HPP */
@@ -0,0 +1,195 @@
+/**
+ * @file	runtime_boundary_mapper.hpp
+ * @brief	Maps values to enum class values using boundaries which can be replaced at run time.
+ * @author	Kacper Kowalski - kacper.s.kowalski@gmail.com
+ */
+
+#ifndef RUNTIME_BOUNDARY_MAPPER_HPP
+#define RUNTIME_BOUNDARY_MAPPER_HPP
+
+#include "boundary_mapper.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <initializer_list>
+#include <iterator>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace jungles {
+
+/**
+ * \brief Maps values to enum class, like boundary_mapper, but the boundaries are provided at run time.
+ *
+ * The boundaries have the same meaning as for boundary_mapper. They are validated and reordered to a search layout
+ * once, when they are loaded: small sets are searched with a branchless binary search, big ones use the Eytzinger
+ * layout (see boundary_search_strategy).
+ *
+ * The boundaries can be replaced with reload() while other threads call convert(). The readers never take a lock nor
+ * wait for the writer: there are two layouts, the active one which is read and the inactive one to which reload()
+ * writes. After the new layout is ready, reload() atomically makes it the active one. Each of the layouts has
+ * a counter of readers, so reload() doesn't touch a layout while a reader, which started before the previous swap,
+ * still uses it. The reloads are serialized with a mutex, which is never taken by convert().
+ *
+ * Usage example: recalibrate a sensor without rebuilding the firmware.
+ */
+template <typename Enum, typename ValueType> class runtime_boundary_mapper
+{
+    static_assert(std::is_enum_v<Enum>, "The first template argument must be an enum");
+
+  public:
+    using enum_type = Enum;
+    using value_type = ValueType;
+
+    /**
+     * \brief Loads the initial boundaries from the range <first, last).
+     *
+     * When the boundaries are not valid (see is_valid()), nothing is loaded: is_loaded() returns false and convert()
+     * returns the first enum value until reload() succeeds.
+     */
+    template <typename ForwardIt> runtime_boundary_mapper(ForwardIt first, ForwardIt last)
+    {
+        if (!is_valid(first, last))
+            return;
+
+        load(m_layouts[0], first, last);
+        m_is_loaded.store(true, std::memory_order_release);
+    }
+
+    runtime_boundary_mapper(std::initializer_list<ValueType> boundaries)
+        : runtime_boundary_mapper(std::begin(boundaries), std::end(boundaries))
+    {
+    }
+
+    runtime_boundary_mapper(const runtime_boundary_mapper &) = delete;
+    runtime_boundary_mapper &operator=(const runtime_boundary_mapper &) = delete;
+
+    //! Thread-safe and lock-free. Can be called concurrently with reload().
+    Enum convert(ValueType val) const
+    {
+        auto idx{acquire_active_layout()};
+        auto res{m_layouts[idx].find_interval(val)};
+        m_num_readers[idx].value.fetch_sub(1, std::memory_order_release);
+        return static_cast<Enum>(res);
+    }
+
+    //! Tells whether valid boundaries have been loaded, either by the constructor or by reload().
+    bool is_loaded() const
+    {
+        return m_is_loaded.load(std::memory_order_acquire);
+    }
+
+    /**
+     * \brief Replaces the boundaries with the ones from the range <first, last).
+     *
+     * Thread-safe. Waits only for the readers which still use the layout from before the previous reload().
+     *
+     * \returns false, and keeps the current boundaries, when the new boundaries are not valid (see is_valid()).
+     */
+    template <typename ForwardIt> bool reload(ForwardIt first, ForwardIt last)
+    {
+        if (!is_valid(first, last))
+            return false;
+
+        std::lock_guard<std::mutex> lock{m_reload_mutex};
+        auto inactive{1 - m_active.load(std::memory_order_relaxed)};
+
+        // The counter is read with a read-modify-write, so it is not older than the increment of a reader which has
+        // seen the layout still active, see acquire_active_layout().
+        while (m_num_readers[inactive].value.fetch_add(0, std::memory_order_acq_rel) != 0)
+            std::this_thread::yield();
+
+        load(m_layouts[inactive], first, last);
+        m_active.store(inactive, std::memory_order_release);
+        m_is_loaded.store(true, std::memory_order_release);
+        return true;
+    }
+
+    bool reload(std::initializer_list<ValueType> boundaries)
+    {
+        return reload(std::begin(boundaries), std::end(boundaries));
+    }
+
+    //! The boundaries are valid when there is at least one boundary and they are strictly ascending.
+    template <typename ForwardIt> static bool is_valid(ForwardIt first, ForwardIt last)
+    {
+        auto is_nan{[](ValueType v) { return v != v; }};
+        return first != last && detail::is_ascending(first, last) && std::none_of(first, last, is_nan);
+    }
+
+  private:
+    struct layout
+    {
+        boundary_search_strategy strategy{boundary_search_strategy::binary};
+        std::size_t num_boundaries{0};
+
+        //! Sorted boundaries or the boundaries in the Eytzinger layout.
+        std::vector<ValueType> values;
+
+        //! Used only for the Eytzinger layout.
+        std::vector<std::size_t> ranks;
+
+        std::size_t find_interval(ValueType val) const
+        {
+            if (strategy == boundary_search_strategy::eytzinger)
+                return detail::eytzinger_lower_bound(values.data(), ranks.data(), num_boundaries, val);
+            else
+                return detail::branchless_lower_bound(values.data(), num_boundaries, val);
+        }
+    };
+
+    //! Keeps the counters of the readers of the two layouts in separate cache lines.
+    struct alignas(64) reader_counter
+    {
+        std::atomic<unsigned> value{0};
+    };
+
+    std::array<layout, 2> m_layouts;
+    alignas(64) std::atomic<unsigned> m_active{0};
+    mutable std::array<reader_counter, 2> m_num_readers{};
+    std::atomic<bool> m_is_loaded{false};
+    std::mutex m_reload_mutex;
+
+    //! Registers the caller as a reader of the active layout and returns its index.
+    unsigned acquire_active_layout() const
+    {
+        while (true)
+        {
+            auto idx{m_active.load(std::memory_order_acquire)};
+            m_num_readers[idx].value.fetch_add(1, std::memory_order_acq_rel);
+
+            // The layouts may have been swapped in the meantime, so reload() could have not seen this reader. When the
+            // layout is still active, the reload() which would write to it reads the counter after this increment.
+            if (m_active.load(std::memory_order_acquire) == idx)
+                return idx;
+            m_num_readers[idx].value.fetch_sub(1, std::memory_order_release);
+        }
+    }
+
+    template <typename ForwardIt> static void load(layout &l, ForwardIt first, ForwardIt last)
+    {
+        std::vector<ValueType> sorted(first, last);
+        l.num_boundaries = sorted.size();
+
+        // The linear search is unrolled at compile time, so binary search is used instead.
+        if (detail::default_search_strategy(l.num_boundaries) == boundary_search_strategy::eytzinger)
+        {
+            l.strategy = boundary_search_strategy::eytzinger;
+            l.values.resize(l.num_boundaries + 1);
+            l.ranks.resize(l.num_boundaries + 1);
+            detail::fill_eytzinger_layout(sorted.data(), l.num_boundaries, l.values.data(), l.ranks.data());
+        }
+        else
+        {
+            l.strategy = boundary_search_strategy::binary;
+            l.values = std::move(sorted);
+            l.ranks.clear();
+        }
+    }
+};
+
+} // namespace jungles
+
+#endif /* RUNTIME_BOUNDARY_MAPPER_HPP */
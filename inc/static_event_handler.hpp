@@ -0,0 +1,45 @@
+/**
+ * @file	static_event_handler.hpp
+ * @brief	Implements an event handler whose handlers are known at compile time.
+ * @author	Kacper Kowalski - kacper.s.kowalski@gmail.com
+ */
+
+#ifndef STATIC_EVENT_HANDLER_HPP
+#define STATIC_EVENT_HANDLER_HPP
+
+#include <functional>
+
+namespace jungles {
+
+// --------------------------------------------------------------------------------------------------------------------
+// DECLARATIONS FOR PUBLIC USE
+// --------------------------------------------------------------------------------------------------------------------
+
+/**
+ * \brief       An event handler with the handlers fixed at compile time.
+ *
+ * The handlers are template parameters, e.g. pointers to functions, so raise() expands into direct calls of them,
+ * in the order of the parameters. There is no type erasure and no storage, thus the compiler can inline the handlers
+ * and optimize across them.
+ *
+ * static_event_handler<&on_button_pressed, &log_button> eh;
+ * eh.raise(button_id);
+ *
+ * The arguments of raise() are passed to each of the handlers by lvalue reference. As the set of the handlers is
+ * fixed, the handlers are never deregistered and the values they return are ignored, so the handlers written for
+ * the basic_event_handler can be reused.
+ *
+ * \tparam Handlers Pointers to functions, or pointers to member functions, which are called on the first argument.
+ */
+template <auto... Handlers> class static_event_handler
+{
+  public:
+    template <typename... Args> static void raise(Args &&...args)
+    {
+        (static_cast<void>(std::invoke(Handlers, args...)), ...);
+    }
+};
+
+} // namespace jungles
+
+#endif /* STATIC_EVENT_HANDLER_HPP */
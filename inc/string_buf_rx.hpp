@@ -49,6 +49,29 @@ template <size_t ImmediateBufferSize> class string_buf_rx
     //! Pop a whole string. When there is no string this returns an empty string.
     std::unique_ptr<std::string> pop_string();
 
+    /**
+     * View the oldest string in the buffer without copying it. The view is split into two parts only when the string
+     * wraps around the end of the buffer. It stays valid until release() is called. When there is no string this
+     * returns an empty view.
+     */
+    cyclic_buf_string_view peek_string() const;
+
+    //! Consume the string returned by peek_string(). Does nothing when there is no string.
+    void release();
+
+    /**
+     * Pop a whole string into s, reusing the capacity of s, thus popping doesn't allocate once s is big enough.
+     * \returns False, and leaves s untouched, when there is no string.
+     */
+    bool pop_string_into(std::string &s);
+
+    /**
+     * Pop a whole string into the buffer p of size n. The string is truncated to n - 1 chars and null-terminated.
+     * \returns The length of the popped string, which is not lower than n when the string has been truncated, or 0
+     * when there is no string.
+     */
+    size_t pop_into(char *p, size_t n);
+
     bool is_empty();
 
   private:
@@ -126,6 +149,43 @@ template <size_t ImmediateBufferSize> std::unique_ptr<std::string> string_buf_rx
     return std::make_unique<std::string>(std::move(s));
 }
 
+template <size_t ImmediateBufferSize> cyclic_buf_string_view string_buf_rx<ImmediateBufferSize>::peek_string() const
+{
+    if (m_end_indexes_cb.is_empty())
+        return {};
+
+    auto len = calc_len_in_circular_buffer(m_cb.tail, m_end_indexes_cb.peek_elem(), ImmediateBufferSize);
+    return m_cb.peek_nelems(len);
+}
+
+template <size_t ImmediateBufferSize> void string_buf_rx<ImmediateBufferSize>::release()
+{
+    if (is_empty())
+        return;
+
+    m_cb.tail = m_end_indexes_cb.pop_elem();
+}
+
+template <size_t ImmediateBufferSize> bool string_buf_rx<ImmediateBufferSize>::pop_string_into(std::string &s)
+{
+    if (is_empty())
+        return false;
+
+    peek_string().copy_to(s);
+    release();
+    return true;
+}
+
+template <size_t ImmediateBufferSize> size_t string_buf_rx<ImmediateBufferSize>::pop_into(char *p, size_t n)
+{
+    if (is_empty())
+        return 0;
+
+    auto len = peek_string().copy_to(p, n);
+    release();
+    return len;
+}
+
 template <size_t ImmediateBufferSize> bool string_buf_rx<ImmediateBufferSize>::is_empty()
 {
     return m_end_indexes_cb.is_empty();
@@ -0,0 +1,156 @@
+/**
+ * @file	work_stealing_pool.hpp
+ * @brief	Implements a pool of threads which steal the tasks from each other.
+ * @author	Kacper Kowalski - kacper.s.kowalski@gmail.com
+ */
+
+#ifndef WORK_STEALING_POOL_HPP
+#define WORK_STEALING_POOL_HPP
+
+#include "inplace_function.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace jungles {
+
+/**
+ * \brief Runs the posted tasks on a fixed number of threads.
+ *
+ * Each of the threads has its own queue of tasks. A task posted from one of the threads of the pool goes to the queue
+ * of that thread, the other tasks are spread over the queues in turns. A thread takes the most recently posted task
+ * from its own queue and, when its queue is empty, steals the oldest task from the queues of the other threads. Thus
+ * a task which takes long doesn't hold back the tasks queued behind it.
+ *
+ * The destructor runs all the posted tasks before joining the threads.
+ */
+class work_stealing_pool
+{
+  public:
+    using task = inplace_function<void(void)>;
+
+    explicit work_stealing_pool(unsigned num_threads = std::max(1u, std::thread::hardware_concurrency()))
+    {
+        for (unsigned i = 0; i < num_threads; ++i)
+            m_queues.emplace_back(std::make_unique<task_queue>());
+        for (unsigned i = 0; i < num_threads; ++i)
+            m_threads.emplace_back([this, i]() { run(i); });
+    }
+
+    ~work_stealing_pool()
+    {
+        {
+            std::lock_guard<std::mutex> lock{m_sleep_mutex};
+            m_is_stopping = true;
+        }
+        m_wake_up.notify_all();
+        for (auto &t : m_threads)
+            t.join();
+    }
+
+    work_stealing_pool(const work_stealing_pool &) = delete;
+    work_stealing_pool &operator=(const work_stealing_pool &) = delete;
+
+    //! Thread-safe. Can be called from the tasks as well.
+    void post(task t)
+    {
+        auto idx{current_pool == this ? current_queue
+                                      : m_next_queue.fetch_add(1, std::memory_order_relaxed) % m_queues.size()};
+
+        // Incremented before the task is queued, so a thread taking it never decrements the counter below zero, and
+        // under the lock, so a thread which has just found all the queues empty doesn't miss the wake up.
+        {
+            std::lock_guard<std::mutex> lock{m_sleep_mutex};
+            ++m_num_pending;
+        }
+        {
+            std::lock_guard<std::mutex> lock{m_queues[idx]->mutex};
+            m_queues[idx]->tasks.push_back(std::move(t));
+        }
+        m_wake_up.notify_one();
+    }
+
+  private:
+    struct task_queue
+    {
+        std::mutex mutex;
+        std::deque<task> tasks;
+    };
+
+    std::vector<std::unique_ptr<task_queue>> m_queues;
+    std::vector<std::thread> m_threads;
+    std::atomic<unsigned> m_next_queue{0};
+
+    //! The number of the tasks posted, but not taken from the queues yet. Signed, so the assertion in run() can
+    //! catch a decrement without a matching increment.
+    std::atomic<std::ptrdiff_t> m_num_pending{0};
+
+    std::mutex m_sleep_mutex;
+    std::condition_variable m_wake_up;
+    bool m_is_stopping{false};
+
+    //! Allow post() to recognize the threads of the pool.
+    inline static thread_local work_stealing_pool *current_pool{nullptr};
+    inline static thread_local std::size_t current_queue{0};
+
+    void run(std::size_t idx)
+    {
+        current_pool = this;
+        current_queue = idx;
+        while (true)
+        {
+            task t;
+            if (try_take(idx, t))
+            {
+                [[maybe_unused]] auto num_pending{--m_num_pending};
+                assert(num_pending >= 0);
+                t();
+                continue;
+            }
+
+            std::unique_lock<std::mutex> lock{m_sleep_mutex};
+            m_wake_up.wait(lock, [this]() { return m_num_pending != 0 || m_is_stopping; });
+            if (m_num_pending == 0 && m_is_stopping)
+                return;
+        }
+    }
+
+    bool try_take(std::size_t idx, task &t)
+    {
+        {
+            auto &own{*m_queues[idx]};
+            std::lock_guard<std::mutex> lock{own.mutex};
+            if (!own.tasks.empty())
+            {
+                t = std::move(own.tasks.back());
+                own.tasks.pop_back();
+                return true;
+            }
+        }
+
+        for (std::size_t i = 1; i < m_queues.size(); ++i)
+        {
+            auto &victim{*m_queues[(idx + i) % m_queues.size()]};
+            std::lock_guard<std::mutex> lock{victim.mutex};
+            if (!victim.tasks.empty())
+            {
+                t = std::move(victim.tasks.front());
+                victim.tasks.pop_front();
+                return true;
+            }
+        }
+        return false;
+    }
+};
+
+} // namespace jungles
+
+#endif /* WORK_STEALING_POOL_HPP */
@@ -0,0 +1,7 @@
+/**
+ * @file	main.cpp
+ * @brief	Definition of main() for the unit tests which require C++20.
+ * @author	Kacper Kowalski - kacper.s.kowalski@gmail.com
+ */
+#define CATCH_CONFIG_MAIN
+#include "ext_deps/catch/catch.hpp"
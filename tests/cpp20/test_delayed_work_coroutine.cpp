@@ -0,0 +1,96 @@
+/**
+ * @file	test_delayed_work_coroutine.cpp
+ * @brief	Tests the coroutine front end of the delayed_work_manager.
+ * @author	Kacper Kowalski - kacper.s.kowalski@gmail.com
+ */
+#include "ext_deps/catch/catch.hpp"
+
+#include "delayed_work_coroutine.hpp"
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+using namespace std::chrono_literals;
+
+using manager_type = delayed_work_manager<10>;
+using pool_type = jungles::coroutine_frame_pool<512, 2>;
+
+static jungles::delayed_task power_on_sequence(manager_type &manager, std::vector<std::string> &steps)
+{
+    steps.push_back("power on " + std::to_string(manager.now().count()));
+    co_await jungles::sleep_for(manager, 50ms);
+    steps.push_back("sample " + std::to_string(manager.now().count()));
+    co_await jungles::sleep_for(manager, 1s);
+    steps.push_back("power off " + std::to_string(manager.now().count()));
+}
+
+static jungles::delayed_task pooled_sequence(pool_type &, manager_type &manager, unsigned &count)
+{
+    for (unsigned i = 0; i < 3; ++i)
+    {
+        co_await jungles::sleep_for(manager, 20u);
+        ++count;
+    }
+}
+
+template <typename Manager>
+static jungles::delayed_task sleep_and_report(Manager &manager, bool &is_slept, bool &is_finished)
+{
+    is_slept = co_await jungles::sleep_for(manager, 10u);
+    is_finished = true;
+}
+
+TEST_CASE("delayed_work_manager coroutines", "[delayed_work_coroutine]")
+{
+    manager_type manager;
+
+    SECTION("Coroutine is resumed after each of the periods")
+    {
+        std::vector<std::string> steps;
+        REQUIRE(power_on_sequence(manager, steps).is_started());
+        REQUIRE(steps == std::vector<std::string>{"power on 0"});
+        manager.invoke(2s);
+        REQUIRE(steps == std::vector<std::string>{"power on 0", "sample 50", "power off 1050"});
+        REQUIRE_FALSE(manager.next_deadline().has_value());
+    }
+
+    SECTION("Frames are allocated from the pool and given back when the coroutines finish")
+    {
+        pool_type pool;
+        unsigned count{0};
+        REQUIRE(pooled_sequence(pool, manager, count).is_started());
+        REQUIRE(pooled_sequence(pool, manager, count).is_started());
+        REQUIRE(pool.num_free_blocks() == 0);
+        REQUIRE_FALSE(pooled_sequence(pool, manager, count).is_started());
+
+        manager.invoke(60u);
+        REQUIRE(count == 6);
+        REQUIRE(pool.num_free_blocks() == 2);
+        REQUIRE(pooled_sequence(pool, manager, count).is_started());
+        manager.invoke(60u);
+        REQUIRE(count == 9);
+    }
+
+    SECTION("Awaiting reports whether the coroutine has slept")
+    {
+        bool is_slept{false};
+        bool is_finished{false};
+        sleep_and_report(manager, is_slept, is_finished);
+        REQUIRE_FALSE(is_finished);
+        manager.invoke();
+        REQUIRE(is_slept);
+        REQUIRE(is_finished);
+    }
+
+    SECTION("Coroutine doesn't sleep when the manager is full")
+    {
+        delayed_work_manager<10, 1> full_manager;
+        full_manager.register_work(10, []() { return delayed_work_policy::keep; });
+        bool is_slept{true};
+        bool is_finished{false};
+        sleep_and_report(full_manager, is_slept, is_finished);
+        REQUIRE_FALSE(is_slept);
+        REQUIRE(is_finished);
+    }
+}
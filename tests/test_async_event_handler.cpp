@@ -0,0 +1,110 @@
+/**
+ * @file	test_async_event_handler.cpp
+ * @brief	Tests the async_event_handler class.
+ * @author	Kacper Kowalski - kacper.s.kowalski@gmail.com
+ */
+#include "ext_deps/catch/catch.hpp"
+
+#include "async_event_handler.hpp"
+
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+TEST_CASE("async_event_handler class unit tests", "[async_event_handler]")
+{
+    SECTION("Events are handled on the dispatcher thread in the order of posting")
+    {
+        std::vector<std::string> events;
+        std::thread::id dispatcher_id;
+        {
+            using handler = jungles::async_event_handler<void(std::string, unsigned), 8>;
+            handler eh;
+            eh.register_handler([&](std::string &s, unsigned &n) {
+                events.push_back(s + std::to_string(n));
+                dispatcher_id = std::this_thread::get_id();
+                return handler::policy::keep;
+            });
+            for (unsigned i = 0; i < 100; ++i)
+                while (!eh.post("event", i))
+                    std::this_thread::yield();
+        }
+        REQUIRE(events.size() == 100);
+        for (unsigned i = 0; i < 100; ++i)
+            REQUIRE(events[i] == "event" + std::to_string(i));
+        REQUIRE(dispatcher_id != std::this_thread::get_id());
+    }
+
+    SECTION("Posting fails when the ring is full")
+    {
+        using handler = jungles::async_event_handler<void(unsigned), 4>;
+        std::atomic<bool> is_released{false};
+        std::atomic<unsigned> num_handled{0};
+        {
+            handler eh;
+            eh.register_handler([&](unsigned &) {
+                while (!is_released)
+                    std::this_thread::yield();
+                ++num_handled;
+                return handler::policy::keep;
+            });
+            // The dispatcher frees the slot of an event after handling it, thus the first event holds a slot.
+            for (unsigned i = 0; i < 4; ++i)
+                REQUIRE(eh.post(i));
+            REQUIRE_FALSE(eh.post(4u));
+            is_released = true;
+        }
+        REQUIRE(num_handled == 4);
+    }
+
+    SECTION("Consecutive equal events are coalesced")
+    {
+        using handler = jungles::async_event_handler<void(unsigned), 16, true>;
+        std::atomic<bool> is_released{false};
+        std::vector<unsigned> events;
+        {
+            handler eh;
+            eh.register_handler([&](unsigned &v) {
+                while (!is_released)
+                    std::this_thread::yield();
+                events.push_back(v);
+                return handler::policy::keep;
+            });
+            REQUIRE(eh.post(0u));
+            for (unsigned v : {1u, 1u, 1u, 2u, 1u, 3u, 3u})
+                REQUIRE(eh.post(v));
+            is_released = true;
+        }
+        // The handler of the first event blocks the dispatcher until all the events are posted.
+        REQUIRE(events == std::vector<unsigned>{0, 1, 2, 1, 3});
+    }
+
+    SECTION("Events posted from many threads are all handled")
+    {
+        constexpr unsigned num_producers{4}, num_events{10000};
+        using handler = jungles::async_event_handler<void(unsigned), 256>;
+        unsigned long long sum{0};
+        unsigned num_handled{0};
+        {
+            handler eh;
+            eh.register_handler([&](unsigned &v) {
+                sum += v;
+                ++num_handled;
+                return handler::policy::keep;
+            });
+            std::vector<std::thread> producers;
+            for (unsigned i = 0; i < num_producers; ++i)
+                producers.emplace_back([&]() {
+                    for (unsigned j = 1; j <= num_events; ++j)
+                        while (!eh.post(j))
+                            std::this_thread::yield();
+                });
+            for (auto &t : producers)
+                t.join();
+        }
+        REQUIRE(num_handled == num_producers * num_events);
+        REQUIRE(sum == num_producers * (num_events * (num_events + 1ull) / 2));
+    }
+}
@@ -76,4 +76,26 @@ TEST_CASE("binary_stream template class unit tests", "[binary_stream]")
         bs.clear();
         REQUIRE(bs.cbegin() == bs.cend());
     }
+
+    SECTION("Can be built at compile time")
+    {
+        static constexpr auto bs{jungles::make_binary_stream(
+            static_cast<uint8_t>(0xAA), static_cast<uint16_t>(0xCCBB), static_cast<uint32_t>(0x11223344))};
+        static_assert(bs.size() == 7);
+        static_assert(bs.data()[0] == 0xAA);
+        const uint8_t result_little_endian[] = {0xAA, 0xBB, 0xCC, 0x44, 0x33, 0x22, 0x11};
+        REQUIRE(std::equal(bs.data(), bs.data() + bs.size(), std::begin(result_little_endian)));
+        REQUIRE(std::equal(bs.cbegin(), bs.cend(), std::begin(result_little_endian)));
+    }
+
+    SECTION("Copy keeps the written data")
+    {
+        jungles::binary_stream<8> bs;
+        REQUIRE(bs.write(static_cast<uint16_t>(0xEEFF)));
+        auto copy{bs};
+        bs.clear();
+        const uint8_t result_little_endian[] = {0xFF, 0xEE};
+        REQUIRE(copy.size() == 2);
+        REQUIRE(std::equal(copy.cbegin(), copy.cend(), std::begin(result_little_endian)));
+    }
 }
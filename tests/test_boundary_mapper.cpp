@@ -7,7 +7,13 @@
 
 #include "boundary_mapper.hpp"
 
+#include <algorithm>
+#include <cstdint>
 #include <experimental/array>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <vector>
 
 enum class test_enum_class
 {
@@ -22,6 +28,41 @@ enum class test_enum_class
 static constexpr auto boundaries{std::experimental::make_array<unsigned>(1, 2, 3, 5, 7)};
 static constexpr auto boundaries_lowest_number{std::experimental::make_array<unsigned>(50)};
 
+//! Used for the tests with many boundaries, where listing all the enumerators makes no sense.
+enum class level : unsigned
+{
+};
+
+template <std::size_t N> static constexpr std::array<unsigned, N> make_boundaries()
+{
+    std::array<unsigned, N> res{};
+    for (std::size_t i = 0; i < N; ++i)
+        res[i] = 10 * i + 5;
+    return res;
+}
+
+static constexpr auto boundaries_4{make_boundaries<4>()};
+static constexpr auto boundaries_16{make_boundaries<16>()};
+static constexpr auto boundaries_64{make_boundaries<64>()};
+static constexpr auto boundaries_200{make_boundaries<200>()};
+static constexpr auto boundaries_256{make_boundaries<256>()};
+static constexpr auto boundaries_full_i8{std::experimental::make_array<int8_t>(-128, -1, 0, 127)};
+static constexpr auto boundaries_u16{std::experimental::make_array<uint16_t>(100, 1000, 40000, 65000)};
+static constexpr auto boundaries_i16{std::experimental::make_array<int16_t>(-1000, -5, 0, 7, 20000)};
+static constexpr auto boundaries_i32{std::experimental::make_array<int32_t>(-100000, -3, 0, 3, 100000)};
+
+template <typename Mapper, std::size_t N>
+static bool is_same_as_lower_bound(const Mapper &mapper, const std::array<unsigned, N> &boundaries)
+{
+    for (unsigned v = 0; v < 10 * N + 20; ++v)
+    {
+        auto expected{std::lower_bound(std::begin(boundaries), std::end(boundaries), v) - std::begin(boundaries)};
+        if (static_cast<std::ptrdiff_t>(mapper.convert(v)) != expected)
+            return false;
+    }
+    return true;
+}
+
 TEST_CASE("boundary_mapper template class unit tests", "[boundary_mapper]")
 {
     SECTION("Positive test for five boundaries")
@@ -46,4 +87,210 @@ TEST_CASE("boundary_mapper template class unit tests", "[boundary_mapper]")
         REQUIRE(bm.convert(50) == test_enum_class::first);
         REQUIRE(bm.convert(51) == test_enum_class::second);
     }
+
+    SECTION("All search strategies give the same results")
+    {
+        using jungles::boundary_search_strategy;
+        static constexpr auto linear{
+            jungles::make_boundary_mapper<test_enum_class, boundaries, boundary_search_strategy::linear>()};
+        static constexpr auto binary{
+            jungles::make_boundary_mapper<test_enum_class, boundaries, boundary_search_strategy::binary>()};
+        static constexpr auto eytzinger{
+            jungles::make_boundary_mapper<test_enum_class, boundaries, boundary_search_strategy::eytzinger>()};
+        static constexpr auto lookup_table{
+            jungles::make_boundary_mapper<test_enum_class, boundaries, boundary_search_strategy::lookup_table>()};
+        for (unsigned v = 0; v < 10; ++v)
+        {
+            REQUIRE(linear.convert(v) == binary.convert(v));
+            REQUIRE(linear.convert(v) == eytzinger.convert(v));
+            REQUIRE(linear.convert(v) == lookup_table.convert(v));
+        }
+
+        REQUIRE(is_same_as_lower_bound(
+            jungles::make_boundary_mapper<level, boundaries_200, boundary_search_strategy::linear>(), boundaries_200));
+        REQUIRE(is_same_as_lower_bound(
+            jungles::make_boundary_mapper<level, boundaries_200, boundary_search_strategy::binary>(), boundaries_200));
+        REQUIRE(is_same_as_lower_bound(
+            jungles::make_boundary_mapper<level, boundaries_200, boundary_search_strategy::eytzinger>(),
+            boundaries_200));
+        REQUIRE(is_same_as_lower_bound(
+            jungles::make_boundary_mapper<level, boundaries_200, boundary_search_strategy::lookup_table>(),
+            boundaries_200));
+    }
+
+    SECTION("Lookup table is used only when it fits the budget")
+    {
+        using jungles::boundary_search_strategy;
+        using jungles::detail::default_search_strategy;
+        static_assert(default_search_strategy<unsigned, 200, boundaries_200>() ==
+                      boundary_search_strategy::lookup_table);
+        static_assert(default_search_strategy<int32_t, 5, boundaries_i32>() == boundary_search_strategy::linear);
+        static_assert(default_search_strategy<uint16_t, 4, boundaries_u16>() == boundary_search_strategy::linear);
+    }
+
+    SECTION("Lookup table clamps values of the whole domain of the type")
+    {
+        static constexpr auto bm{jungles::make_boundary_mapper<level, boundaries_full_i8>()};
+        static_assert(jungles::detail::default_search_strategy<int8_t, 4, boundaries_full_i8>() ==
+                      jungles::boundary_search_strategy::lookup_table);
+        for (int v = std::numeric_limits<int8_t>::min(); v <= std::numeric_limits<int8_t>::max(); ++v)
+        {
+            auto val{static_cast<int8_t>(v)};
+            auto expected{std::lower_bound(std::begin(boundaries_full_i8), std::end(boundaries_full_i8), val) -
+                          std::begin(boundaries_full_i8)};
+            REQUIRE(static_cast<std::ptrdiff_t>(bm.convert(val)) == expected);
+        }
+    }
+
+    SECTION("Default search strategy works for various numbers of boundaries")
+    {
+        REQUIRE(is_same_as_lower_bound(jungles::make_boundary_mapper<level, boundaries_4>(), boundaries_4));
+        REQUIRE(is_same_as_lower_bound(jungles::make_boundary_mapper<level, boundaries_16>(), boundaries_16));
+        REQUIRE(is_same_as_lower_bound(jungles::make_boundary_mapper<level, boundaries_64>(), boundaries_64));
+        REQUIRE(is_same_as_lower_bound(jungles::make_boundary_mapper<level, boundaries_256>(), boundaries_256));
+    }
+
+    SECTION("Conversion can be done at compile time")
+    {
+        static constexpr auto bm{jungles::make_boundary_mapper<level, boundaries_256>()};
+        static_assert(bm.convert(0) == level{0});
+        static_assert(bm.convert(2000) == level{200});
+        static_assert(bm.convert(3000) == level{256});
+    }
+}
+
+template <typename Mapper, typename T>
+static bool is_same_as_convert(const Mapper &mapper, const std::vector<T> &values)
+{
+    std::vector<level> out(values.size());
+    mapper.convert_many(values.data(), values.size(), out.data());
+    for (std::size_t i = 0; i < values.size(); ++i)
+        if (out[i] != mapper.convert(values[i]))
+            return false;
+    return true;
+}
+
+template <typename T> static std::vector<T> make_random_values(std::size_t count)
+{
+    std::mt19937 gen{1};
+    std::uniform_int_distribution<int64_t> dist{std::numeric_limits<T>::lowest(), std::numeric_limits<T>::max()};
+    std::vector<T> values(count);
+    std::generate(std::begin(values), std::end(values), [&]() { return static_cast<T>(dist(gen)); });
+    return values;
+}
+
+TEST_CASE("boundary_mapper converts many values at once", "[boundary_mapper]")
+{
+    SECTION("Results are the same as for single conversions")
+    {
+        // 1001 values, so there are remaining values which don't fill a whole vector.
+        REQUIRE(is_same_as_convert(jungles::make_boundary_mapper<level, boundaries_u16>(),
+                                   make_random_values<uint16_t>(1001)));
+        REQUIRE(is_same_as_convert(jungles::make_boundary_mapper<level, boundaries_i16>(),
+                                   make_random_values<int16_t>(1001)));
+        REQUIRE(is_same_as_convert(jungles::make_boundary_mapper<level, boundaries_i32>(),
+                                   make_random_values<int32_t>(1001)));
+        REQUIRE(is_same_as_convert(jungles::make_boundary_mapper<level, boundaries_64>(),
+                                   make_random_values<unsigned>(1001)));
+        std::vector<unsigned> small_values(1001);
+        std::iota(std::begin(small_values), std::end(small_values), 0);
+        REQUIRE(is_same_as_convert(jungles::make_boundary_mapper<level, boundaries_256>(), small_values));
+    }
+
+    SECTION("Boundaries themselves are mapped to the lower interval")
+    {
+        std::array<level, std::size(boundaries_16)> out;
+        jungles::make_boundary_mapper<level, boundaries_16>().convert_many(
+            boundaries_16.data(), boundaries_16.size(), out.data());
+        for (unsigned i = 0; i < out.size(); ++i)
+            REQUIRE(out[i] == level{i});
+    }
+
+    SECTION("Converting no values does nothing")
+    {
+        unsigned in[1]{3};
+        level out[1]{level{100}};
+        jungles::make_boundary_mapper<level, boundaries_16>().convert_many(in, 0, out);
+        REQUIRE(out[0] == level{100});
+    }
+}
+
+template <typename Mapper> static unsigned benchmark_convert(const Mapper &mapper, const std::vector<unsigned> &values)
+{
+    unsigned res = 0;
+    for (auto v : values)
+        res += static_cast<unsigned>(mapper.convert(v));
+    return res;
+}
+
+template <const auto &Boundaries> static void benchmark_strategies(const char *name)
+{
+    using jungles::boundary_search_strategy;
+    std::mt19937 gen{1};
+    std::uniform_int_distribution<unsigned> dist{0, static_cast<unsigned>(10 * std::size(Boundaries) + 10)};
+    std::vector<unsigned> values(4096);
+    std::generate(std::begin(values), std::end(values), [&]() { return dist(gen); });
+
+    static constexpr auto linear{jungles::make_boundary_mapper<level, Boundaries, boundary_search_strategy::linear>()};
+    static constexpr auto binary{jungles::make_boundary_mapper<level, Boundaries, boundary_search_strategy::binary>()};
+    static constexpr auto eytzinger{
+        jungles::make_boundary_mapper<level, Boundaries, boundary_search_strategy::eytzinger>()};
+    static constexpr auto lookup_table{
+        jungles::make_boundary_mapper<level, Boundaries, boundary_search_strategy::lookup_table>()};
+
+    BENCHMARK(std::string{name} + " linear")
+    {
+        return benchmark_convert(linear, values);
+    };
+    BENCHMARK(std::string{name} + " binary")
+    {
+        return benchmark_convert(binary, values);
+    };
+    BENCHMARK(std::string{name} + " eytzinger")
+    {
+        return benchmark_convert(eytzinger, values);
+    };
+    BENCHMARK(std::string{name} + " lookup table")
+    {
+        return benchmark_convert(lookup_table, values);
+    };
+}
+
+TEST_CASE("boundary_mapper convert() benchmark across boundary counts", "[boundary_mapper][!benchmark]")
+{
+    benchmark_strategies<boundaries_4>("4 boundaries,");
+    benchmark_strategies<boundaries_16>("16 boundaries,");
+    benchmark_strategies<boundaries_64>("64 boundaries,");
+    benchmark_strategies<boundaries_256>("256 boundaries,");
+}
+
+template <const auto &Boundaries> static void benchmark_convert_many(const char *name)
+{
+    std::mt19937 gen{1};
+    std::uniform_int_distribution<unsigned> dist{0, static_cast<unsigned>(10 * std::size(Boundaries) + 10)};
+    std::vector<unsigned> values(4096);
+    std::generate(std::begin(values), std::end(values), [&]() { return dist(gen); });
+    std::vector<level> out(values.size());
+
+    static constexpr auto bm{jungles::make_boundary_mapper<level, Boundaries>()};
+
+    BENCHMARK(std::string{name} + " convert() one by one")
+    {
+        for (std::size_t i = 0; i < values.size(); ++i)
+            out[i] = bm.convert(values[i]);
+        return out.back();
+    };
+    BENCHMARK(std::string{name} + " convert_many()")
+    {
+        bm.convert_many(values.data(), values.size(), out.data());
+        return out.back();
+    };
+}
+
+TEST_CASE("boundary_mapper convert_many() throughput benchmark", "[boundary_mapper][!benchmark]")
+{
+    benchmark_convert_many<boundaries_4>("4 boundaries,");
+    benchmark_convert_many<boundaries_16>("16 boundaries,");
+    benchmark_convert_many<boundaries_64>("64 boundaries,");
+    benchmark_convert_many<boundaries_256>("256 boundaries,");
 }
@@ -0,0 +1,97 @@
+/**
+ * @file	test_boundary_transition_stream.cpp
+ * @brief	Tests the boundary_transition_stream template class
+ * @author	Kacper Kowalski - kacper.s.kowalski@gmail.com
+ */
+#include "ext_deps/catch/catch.hpp"
+
+#include "boundary_mapper.hpp"
+#include "boundary_transition_stream.hpp"
+#include "runtime_boundary_mapper.hpp"
+
+#include <experimental/array>
+#include <iterator>
+#include <limits>
+#include <vector>
+
+enum class wetness
+{
+    dry = 0,
+    moist,
+    wet,
+};
+
+static constexpr auto wetness_boundaries{std::experimental::make_array<int>(100, 200)};
+
+TEST_CASE("boundary_transition_stream template class unit tests", "[boundary_transition_stream]")
+{
+    static constexpr auto bm{jungles::make_boundary_mapper<wetness, wetness_boundaries>()};
+    using stream_type = jungles::boundary_transition_stream<std::decay_t<decltype(bm)>>;
+    using transition = stream_type::transition;
+
+    SECTION("Reports the initial level and then only the changes")
+    {
+        stream_type s{bm};
+        std::vector<int> samples{10, 20, 30, 150, 160, 250, 260, 250, 50};
+        std::vector<transition> transitions;
+        s.push(std::begin(samples), std::end(samples), std::back_inserter(transitions));
+        REQUIRE(transitions ==
+                std::vector<transition>{{0, wetness::dry}, {3, wetness::moist}, {5, wetness::wet}, {8, wetness::dry}});
+        REQUIRE(s.level() == wetness::dry);
+    }
+
+    SECTION("Indexes the samples across blocks")
+    {
+        stream_type s{bm};
+        std::vector<int> first_block{10, 20};
+        std::vector<int> second_block{20, 120};
+        std::vector<transition> transitions;
+        s.push(std::begin(first_block), std::end(first_block), std::back_inserter(transitions));
+        s.push(std::begin(second_block), std::end(second_block), std::back_inserter(transitions));
+        REQUIRE(transitions == std::vector<transition>{{0, wetness::dry}, {3, wetness::moist}});
+    }
+
+    SECTION("Hysteresis suppresses flapping around a boundary")
+    {
+        stream_type s{bm, 10};
+        std::vector<int> samples{95, 105, 98, 110, 111, 95, 91, 90, 89};
+        std::vector<transition> transitions;
+        s.push(std::begin(samples), std::end(samples), std::back_inserter(transitions));
+        REQUIRE(transitions == std::vector<transition>{{0, wetness::dry}, {4, wetness::moist}, {7, wetness::dry}});
+    }
+
+    SECTION("Hysteresis doesn't skip over levels which are far enough")
+    {
+        stream_type s{bm, 10};
+        REQUIRE(s.push(0) == transition{0, wetness::dry});
+        // Beyond the first boundary, but within the band of the second one.
+        REQUIRE(s.push(205) == transition{1, wetness::moist});
+        REQUIRE(s.push(211) == transition{2, wetness::wet});
+        REQUIRE(s.push(-1000) == transition{3, wetness::dry});
+    }
+
+    SECTION("Hysteresis saturates at the limits of the value type")
+    {
+        stream_type s{bm, 10};
+        REQUIRE(s.push(std::numeric_limits<int>::max()) == transition{0, wetness::wet});
+        REQUIRE(s.push(std::numeric_limits<int>::lowest()) == transition{1, wetness::dry});
+    }
+
+    SECTION("Reset starts from the beginning")
+    {
+        stream_type s{bm};
+        REQUIRE(s.push(150).has_value());
+        REQUIRE_FALSE(s.push(150).has_value());
+        s.reset();
+        REQUIRE_FALSE(s.level().has_value());
+        REQUIRE(s.push(150) == transition{0, wetness::moist});
+    }
+
+    SECTION("Works with runtime_boundary_mapper")
+    {
+        jungles::runtime_boundary_mapper<wetness, int> rbm{100, 200};
+        jungles::boundary_transition_stream s{rbm};
+        REQUIRE(s.push(150) == transition{0, wetness::moist});
+        REQUIRE_FALSE(s.push(160).has_value());
+    }
+}
@@ -0,0 +1,95 @@
+/**
+ * @file	test_concurrent_event_handler.cpp
+ * @brief	Tests the concurrent_event_handler class.
+ * @author	Kacper Kowalski - kacper.s.kowalski@gmail.com
+ */
+#include "ext_deps/catch/catch.hpp"
+
+#include "concurrent_event_handler.hpp"
+
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+TEST_CASE("concurrent_event_handler class unit tests", "[concurrent_event_handler]")
+{
+    using handler = jungles::concurrent_event_handler<unsigned>;
+    handler eh;
+
+    SECTION("Handlers get the payload and are deregistered when they ask to")
+    {
+        unsigned sum{0}, num_once_invocations{0};
+        eh.register_handler([&](unsigned &v) {
+            sum += v;
+            return handler::policy::keep;
+        });
+        eh.register_handler([&](unsigned &) {
+            ++num_once_invocations;
+            return handler::policy::deregister;
+        });
+        eh.raise(2u);
+        eh.raise(3u);
+        REQUIRE(sum == 5);
+        REQUIRE(num_once_invocations == 1);
+    }
+
+    SECTION("Handler registered by a handler is invoked from the next raise")
+    {
+        unsigned num_invocations{0};
+        eh.register_handler([&](unsigned &) {
+            eh.register_handler([&](unsigned &) {
+                ++num_invocations;
+                return handler::policy::keep;
+            });
+            return handler::policy::deregister;
+        });
+        eh.raise(0u);
+        REQUIRE(num_invocations == 0);
+        eh.raise(0u);
+        REQUIRE(num_invocations == 1);
+    }
+
+    SECTION("Deregistered handler is destroyed once no raise uses it")
+    {
+        auto token{std::make_shared<int>(0)};
+        eh.register_handler([token](unsigned &) { return handler::policy::deregister; });
+        REQUIRE(token.use_count() == 2);
+        eh.raise(0u);
+        REQUIRE(token.use_count() == 1);
+    }
+
+    SECTION("Raises from many threads while other threads register and deregister the handlers")
+    {
+        constexpr unsigned num_raising_threads{4}, num_raises{2000}, num_registrations{200};
+        std::atomic<unsigned> num_keep_invocations{0}, num_once_invocations{0};
+        eh.register_handler([&](unsigned &) {
+            ++num_keep_invocations;
+            return handler::policy::keep;
+        });
+
+        std::vector<std::thread> threads;
+        for (unsigned i = 0; i < num_raising_threads; ++i)
+            threads.emplace_back([&]() {
+                for (unsigned j = 0; j < num_raises; ++j)
+                    eh.raise(j);
+            });
+        threads.emplace_back([&]() {
+            for (unsigned j = 0; j < num_registrations; ++j)
+                eh.register_handler([&](unsigned &) {
+                    ++num_once_invocations;
+                    return handler::policy::deregister;
+                });
+        });
+        for (auto &t : threads)
+            t.join();
+
+        // Runs each of the remaining handlers, which asks to be deregistered, for the last time.
+        eh.raise(0u);
+        auto num_once_invocations_before{num_once_invocations.load()};
+        eh.raise(0u);
+        REQUIRE(num_keep_invocations == num_raising_threads * num_raises + 2);
+        REQUIRE(num_once_invocations_before >= num_registrations);
+        REQUIRE(num_once_invocations == num_once_invocations_before);
+    }
+}
@@ -0,0 +1,758 @@
+/**
+ * @file	test_delayed_work_manager.cpp
+ * @brief	Tests the delayed_work_manager template class
+ * @author	Kacper Kowalski - kacper.s.kowalski@gmail.com
+ */
+#include "ext_deps/catch/catch.hpp"
+
+#include "delayed_work_manager.hpp"
+#include "work_stealing_pool.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+TEST_CASE("delayed_work_manager template class unit tests", "[delayed_work_manager]")
+{
+    SECTION("Periodic work is invoked with its period")
+    {
+        delayed_work_manager<10> dwm;
+        std::vector<unsigned> invoked_at;
+        unsigned tick{0};
+        dwm.register_work(30, [&]() {
+            invoked_at.push_back(tick);
+            return delayed_work_policy::keep;
+        });
+        for (tick = 1; tick <= 10; ++tick)
+            dwm.invoke();
+        REQUIRE(invoked_at == std::vector<unsigned>{3, 6, 9});
+    }
+
+    SECTION("Single shot work is invoked once after the delay")
+    {
+        delayed_work_manager<1> dwm;
+        unsigned count{0};
+        dwm.register_work(5, [&]() {
+            ++count;
+            return delayed_work_policy::deregister;
+        });
+        for (unsigned i = 0; i < 4; ++i)
+            dwm.invoke();
+        REQUIRE(count == 0);
+        dwm.invoke();
+        REQUIRE(count == 1);
+        for (unsigned i = 0; i < 20; ++i)
+            dwm.invoke();
+        REQUIRE(count == 1);
+    }
+
+    SECTION("Work registered from a handler is invoked after its own period")
+    {
+        delayed_work_manager<1> dwm;
+        std::vector<unsigned> invoked_at;
+        unsigned tick{0};
+        dwm.register_work(2, [&]() {
+            dwm.register_work(3, [&]() {
+                invoked_at.push_back(tick);
+                return delayed_work_policy::deregister;
+            });
+            return delayed_work_policy::deregister;
+        });
+        for (tick = 1; tick <= 10; ++tick)
+            dwm.invoke();
+        REQUIRE(invoked_at == std::vector<unsigned>{5});
+    }
+
+    SECTION("Work with long periods is cascaded through all the levels of the wheel")
+    {
+        delayed_work_manager<1> dwm;
+        std::vector<unsigned> invoked_at;
+        unsigned tick{0};
+        for (unsigned period : {63u, 64u, 65u, 4095u, 4097u, 262145u, (1u << 24) + 3})
+        {
+            dwm.register_work(period, [&]() {
+                invoked_at.push_back(tick);
+                return delayed_work_policy::deregister;
+            });
+        }
+        for (tick = 1; tick <= (1u << 24) + 10; ++tick)
+            dwm.invoke();
+        REQUIRE(invoked_at == std::vector<unsigned>{63, 64, 65, 4095, 4097, 262145, (1u << 24) + 3});
+    }
+
+    SECTION("Many jobs with random periods are invoked at the right ticks")
+    {
+        delayed_work_manager<1> dwm;
+        std::mt19937 gen{1};
+        std::uniform_int_distribution<unsigned> dist{1, 5000};
+        constexpr unsigned num_jobs{500};
+        constexpr unsigned num_ticks{20000};
+        std::vector<unsigned> periods(num_jobs);
+        std::vector<std::vector<unsigned>> invoked_at(num_jobs);
+        unsigned tick{0};
+        for (unsigned i = 0; i < num_jobs; ++i)
+        {
+            periods[i] = dist(gen);
+            dwm.register_work(periods[i], [&, i]() {
+                invoked_at[i].push_back(tick);
+                return delayed_work_policy::keep;
+            });
+        }
+        for (tick = 1; tick <= num_ticks; ++tick)
+            dwm.invoke();
+
+        for (unsigned i = 0; i < num_jobs; ++i)
+        {
+            std::vector<unsigned> expected;
+            for (unsigned t = periods[i]; t <= num_ticks; t += periods[i])
+                expected.push_back(t);
+            REQUIRE(invoked_at[i] == expected);
+        }
+    }
+
+    SECTION("Work can be deregistered after multiple invocations")
+    {
+        delayed_work_manager<1> dwm;
+        unsigned count{0};
+        dwm.register_work(
+            2, [&]() { return ++count == 3 ? delayed_work_policy::deregister : delayed_work_policy::keep; });
+        for (unsigned i = 0; i < 100; ++i)
+            dwm.invoke();
+        REQUIRE(count == 3);
+    }
+
+    SECTION("Fixed capacity manager refuses work when full and reuses the slots of finished work")
+    {
+        delayed_work_manager<1, 3> dwm;
+        unsigned count{0};
+        auto single_shot{[&]() {
+            ++count;
+            return delayed_work_policy::deregister;
+        }};
+        REQUIRE(dwm.register_work(1, single_shot).is_registered());
+        REQUIRE(dwm.register_work(2, single_shot).is_registered());
+        REQUIRE(dwm.register_work(2, single_shot).is_registered());
+        REQUIRE_FALSE(dwm.register_work(1, single_shot).is_registered());
+
+        dwm.invoke();
+        REQUIRE(count == 1);
+        REQUIRE(dwm.register_work(1, single_shot).is_registered());
+        REQUIRE_FALSE(dwm.register_work(1, single_shot).is_registered());
+
+        dwm.invoke();
+        REQUIRE(count == 4);
+        for (unsigned i = 0; i < 3; ++i)
+            REQUIRE(dwm.register_work(5, single_shot).is_registered());
+        dwm.invoke(5);
+        REQUIRE(count == 7);
+    }
+
+    SECTION("The slot of a handler is freed only after the handler returns")
+    {
+        delayed_work_manager<1, 1> dwm;
+        std::vector<unsigned> invoked_at;
+        unsigned tick{0};
+        bool is_registered{false};
+        dwm.register_work(2, [&]() {
+            is_registered = dwm.register_work(1, []() { return delayed_work_policy::deregister; }).is_registered();
+            invoked_at.push_back(tick);
+            return delayed_work_policy::deregister;
+        });
+        for (tick = 1; tick <= 5; ++tick)
+            dwm.invoke();
+        REQUIRE(invoked_at == std::vector<unsigned>{2});
+        REQUIRE_FALSE(is_registered);
+        REQUIRE(dwm.register_work(1, []() { return delayed_work_policy::deregister; }).is_registered());
+    }
+}
+
+TEST_CASE("delayed_work_manager work handles", "[delayed_work_manager]")
+{
+    delayed_work_manager<1> dwm;
+    std::vector<unsigned> invoked_at;
+    unsigned tick{0};
+    auto periodic{[&]() {
+        invoked_at.push_back(tick);
+        return delayed_work_policy::keep;
+    }};
+    auto run_until{[&](unsigned end) {
+        while (tick < end)
+        {
+            ++tick;
+            dwm.invoke();
+        }
+    }};
+
+    SECTION("Default constructed handle refers to no work")
+    {
+        delayed_work_manager<1>::work_handle h;
+        REQUIRE_FALSE(h.is_registered());
+        REQUIRE_FALSE(h.cancel());
+        REQUIRE_FALSE(h.reschedule(5));
+    }
+
+    SECTION("Cancelled work is not invoked any more")
+    {
+        auto h{dwm.register_work(3, periodic)};
+        REQUIRE(h.is_registered());
+        run_until(7);
+        REQUIRE(h.cancel());
+        REQUIRE_FALSE(h.is_registered());
+        REQUIRE_FALSE(h.cancel());
+        run_until(20);
+        REQUIRE(invoked_at == std::vector<unsigned>{3, 6});
+        REQUIRE_FALSE(dwm.next_deadline().has_value());
+    }
+
+    SECTION("Handle to finished work doesn't refer to the work which reuses its slot")
+    {
+        auto h{dwm.register_work(2, []() { return delayed_work_policy::deregister; })};
+        run_until(2);
+        REQUIRE_FALSE(h.is_registered());
+        auto other{dwm.register_work(2, periodic)};
+        REQUIRE_FALSE(h.cancel());
+        REQUIRE_FALSE(h.reschedule(1));
+        REQUIRE(other.is_registered());
+        run_until(6);
+        REQUIRE(invoked_at == std::vector<unsigned>{4, 6});
+    }
+
+    SECTION("Rescheduled work is due after the new period counting from now")
+    {
+        auto h{dwm.register_work(100000, periodic)};
+        run_until(10);
+        REQUIRE(h.reschedule(4));
+        REQUIRE(dwm.next_deadline() == std::chrono::milliseconds{4});
+        run_until(22);
+        REQUIRE(invoked_at == std::vector<unsigned>{14, 18, 22});
+    }
+
+    SECTION("Work can cancel itself from its handler")
+    {
+        delayed_work_manager<1>::work_handle h;
+        h = dwm.register_work(2, [&]() {
+            invoked_at.push_back(tick);
+            if (tick == 4)
+                REQUIRE(h.cancel());
+            return delayed_work_policy::keep;
+        });
+        run_until(10);
+        REQUIRE(invoked_at == std::vector<unsigned>{2, 4});
+        REQUIRE_FALSE(h.is_registered());
+    }
+
+    SECTION("Work can change its own period from its handler")
+    {
+        delayed_work_manager<1>::work_handle h;
+        h = dwm.register_work(2, [&]() {
+            invoked_at.push_back(tick);
+            h.reschedule(5);
+            return delayed_work_policy::keep;
+        });
+        run_until(12);
+        REQUIRE(invoked_at == std::vector<unsigned>{2, 7, 12});
+    }
+
+    SECTION("Work can cancel other work due in the same tick")
+    {
+        delayed_work_manager<1>::work_handle a, b;
+        a = dwm.register_work(5, [&]() {
+            invoked_at.push_back(1);
+            b.cancel();
+            return delayed_work_policy::keep;
+        });
+        b = dwm.register_work(5, [&]() {
+            invoked_at.push_back(2);
+            a.cancel();
+            return delayed_work_policy::keep;
+        });
+        run_until(20);
+
+        // Whichever is invoked first, the other one is never invoked.
+        REQUIRE(invoked_at.size() == 4);
+        REQUIRE(std::count(std::begin(invoked_at), std::end(invoked_at), invoked_at.front()) == 4);
+    }
+}
+
+TEST_CASE("delayed_work_manager work submission", "[delayed_work_manager]")
+{
+    SECTION("Submitted work is registered at the beginning of the next invocation")
+    {
+        delayed_work_manager<1> dwm;
+        std::vector<unsigned> invoked_at;
+        unsigned tick{0};
+        dwm.invoke();
+        dwm.submit_work(3, [&]() {
+            invoked_at.push_back(tick);
+            return delayed_work_policy::keep;
+        });
+        REQUIRE_FALSE(dwm.next_deadline().has_value());
+        for (tick = 2; tick <= 10; ++tick)
+            dwm.invoke();
+        REQUIRE(invoked_at == std::vector<unsigned>{4, 7, 10});
+    }
+
+    SECTION("Submitted work is dropped when a fixed capacity manager is full")
+    {
+        delayed_work_manager<1, 2> dwm;
+        std::vector<unsigned> invoked_at;
+        unsigned tick{0};
+        auto handler{[&]() {
+            invoked_at.push_back(tick);
+            return delayed_work_policy::deregister;
+        }};
+        REQUIRE(dwm.register_work(1, handler).is_registered());
+        REQUIRE(dwm.submit_work(2, handler));
+        REQUIRE(dwm.submit_work(2, handler));
+        for (tick = 1; tick <= 4; ++tick)
+            dwm.invoke();
+        REQUIRE(invoked_at == std::vector<unsigned>{1, 2});
+
+        REQUIRE(dwm.submit_work(2, handler));
+        for (tick = 5; tick <= 6; ++tick)
+            dwm.invoke();
+        REQUIRE(invoked_at == std::vector<unsigned>{1, 2, 6});
+    }
+
+    SECTION("Submission queue of a fixed capacity manager fits all its jobs")
+    {
+        delayed_work_manager<1, 5> dwm;
+        unsigned count{0};
+        for (unsigned i = 0; i < 8; ++i)
+            REQUIRE(dwm.submit_work(1, [&]() {
+                ++count;
+                return delayed_work_policy::deregister;
+            }));
+        REQUIRE_FALSE(dwm.submit_work(1, []() { return delayed_work_policy::deregister; }));
+        dwm.invoke();
+        REQUIRE(count == 5);
+    }
+
+    SECTION("Submission fails when the queue is full")
+    {
+        delayed_work_manager<1> dwm;
+        unsigned count{0};
+        auto handler{[&]() {
+            ++count;
+            return delayed_work_policy::deregister;
+        }};
+        for (unsigned i = 0; i < JUNGLES_DELAYED_WORK_SUBMISSION_QUEUE_SIZE; ++i)
+            REQUIRE(dwm.submit_work(1, handler));
+        REQUIRE_FALSE(dwm.submit_work(1, handler));
+
+        dwm.invoke();
+        REQUIRE(count == JUNGLES_DELAYED_WORK_SUBMISSION_QUEUE_SIZE);
+        REQUIRE(dwm.submit_work(1, handler));
+        dwm.invoke();
+        REQUIRE(count == JUNGLES_DELAYED_WORK_SUBMISSION_QUEUE_SIZE + 1);
+    }
+
+    SECTION("Work submitted concurrently from many threads is invoked")
+    {
+        delayed_work_manager<1> dwm;
+        constexpr unsigned num_threads{4};
+        constexpr unsigned num_jobs_per_thread{1000};
+        std::atomic<unsigned> num_submitting{num_threads};
+        unsigned count{0};
+
+        std::vector<std::thread> threads;
+        for (unsigned t = 0; t < num_threads; ++t)
+            threads.emplace_back([&, t]() {
+                for (unsigned i = 0; i < num_jobs_per_thread; ++i)
+                    while (!dwm.submit_work(1 + (t + i) % 7, [&]() {
+                        ++count;
+                        return delayed_work_policy::deregister;
+                    }))
+                        std::this_thread::yield();
+                --num_submitting;
+            });
+
+        while (num_submitting != 0)
+            dwm.invoke();
+        for (auto &t : threads)
+            t.join();
+        dwm.invoke(8);
+
+        REQUIRE(count == num_threads * num_jobs_per_thread);
+        REQUIRE_FALSE(dwm.next_deadline().has_value());
+    }
+}
+
+//! The pool is destroyed first, so all the handlers finish before the manager is destroyed.
+struct manager_with_pool
+{
+    delayed_work_manager<1> dwm{[this](jungles::inplace_function<void(void)> task) { pool.post(std::move(task)); }};
+    jungles::work_stealing_pool pool{4};
+};
+
+//! Ticks until the condition is met, giving the handlers some time to run.
+template <typename Condition> static bool invoke_until(manager_with_pool &mp, Condition condition)
+{
+    for (unsigned i = 0; i < 10000 && !condition(); ++i)
+    {
+        mp.dwm.invoke();
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+    }
+    return condition();
+}
+
+// Each section creates the manager after the state captured by its handlers, so the handlers finish before the state
+// goes out of scope.
+TEST_CASE("delayed_work_manager with an executor", "[delayed_work_manager]")
+{
+    SECTION("Slow handler doesn't delay the other handlers")
+    {
+        std::atomic<bool> is_released{false};
+        std::atomic<unsigned> fast_count{0};
+        manager_with_pool mp;
+        auto &dwm{mp.dwm};
+        dwm.register_work(1, [&]() {
+            while (!is_released)
+                std::this_thread::yield();
+            return delayed_work_policy::deregister;
+        });
+        dwm.register_work(1, [&]() {
+            ++fast_count;
+            return delayed_work_policy::keep;
+        });
+        REQUIRE(invoke_until(mp, [&]() { return fast_count >= 10; }));
+        is_released = true;
+    }
+
+    SECTION("Periodic handler doesn't overlap with itself")
+    {
+        std::atomic<unsigned> num_running{0};
+        std::atomic<unsigned> max_running{0};
+        std::atomic<unsigned> count{0};
+        manager_with_pool mp;
+        auto &dwm{mp.dwm};
+        dwm.register_work(1, [&]() {
+            auto running{++num_running};
+            if (running > max_running)
+                max_running = running;
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            --num_running;
+            ++count;
+            return delayed_work_policy::keep;
+        });
+        REQUIRE(invoke_until(mp, [&]() { return count >= 20; }));
+        REQUIRE(max_running == 1);
+    }
+
+    SECTION("The returned policy is applied after the handler returns")
+    {
+        std::atomic<unsigned> count{0};
+        manager_with_pool mp;
+        auto &dwm{mp.dwm};
+        auto h{dwm.register_work(2, [&]() {
+            return ++count == 3 ? delayed_work_policy::deregister : delayed_work_policy::keep;
+        })};
+        REQUIRE(invoke_until(mp, [&]() { return !h.is_registered(); }));
+        for (unsigned i = 0; i < 10; ++i)
+            dwm.invoke();
+        REQUIRE(count == 3);
+    }
+
+    SECTION("Work cancelled while its handler runs is deregistered")
+    {
+        std::atomic<bool> is_running{false};
+        std::atomic<bool> is_released{false};
+        std::atomic<unsigned> count{0};
+        manager_with_pool mp;
+        auto &dwm{mp.dwm};
+        auto h{dwm.register_work(1, [&]() {
+            ++count;
+            is_running = true;
+            while (!is_released)
+                std::this_thread::yield();
+            return delayed_work_policy::keep;
+        })};
+        REQUIRE(invoke_until(mp, [&]() { return is_running.load(); }));
+        REQUIRE(h.cancel());
+        is_released = true;
+        for (unsigned i = 0; i < 10; ++i)
+            dwm.invoke();
+        REQUIRE(count == 1);
+    }
+}
+
+TEST_CASE("delayed_work_manager tickless operation", "[delayed_work_manager]")
+{
+    using namespace std::chrono_literals;
+
+    SECTION("There is no deadline when no work is registered")
+    {
+        delayed_work_manager<10> dwm;
+        REQUIRE_FALSE(dwm.next_deadline().has_value());
+    }
+
+    SECTION("Next deadline is the time left to the earliest work")
+    {
+        delayed_work_manager<10> dwm;
+        dwm.register_work(500, []() { return delayed_work_policy::deregister; });
+        dwm.register_work(70000, []() { return delayed_work_policy::deregister; });
+        REQUIRE(dwm.next_deadline() == 500ms);
+        dwm.invoke(100);
+        REQUIRE(dwm.next_deadline() == 400ms);
+        dwm.invoke(400);
+        REQUIRE(dwm.next_deadline() == 69500ms);
+        dwm.invoke(69490);
+        REQUIRE(dwm.next_deadline() == 10ms);
+        dwm.invoke();
+        REQUIRE_FALSE(dwm.next_deadline().has_value());
+    }
+
+    SECTION("Next deadline is found on each level of the wheel")
+    {
+        delayed_work_manager<1> dwm;
+        for (unsigned period : {(1u << 24) + 1000, 300000u, 5000u, 100u, 7u})
+        {
+            dwm.register_work(period, []() { return delayed_work_policy::deregister; });
+            REQUIRE(dwm.next_deadline() == std::chrono::milliseconds{period});
+        }
+    }
+
+    SECTION("Skipped periods are caught up in order")
+    {
+        delayed_work_manager<1> dwm;
+        std::vector<std::string> invocations;
+        unsigned a_count{0};
+        dwm.register_work(3, [&]() {
+            invocations.push_back("a" + std::to_string(++a_count));
+            return delayed_work_policy::keep;
+        });
+        dwm.register_work(5, [&]() {
+            invocations.push_back("b");
+            return delayed_work_policy::deregister;
+        });
+        dwm.invoke(10);
+        REQUIRE(invocations == std::vector<std::string>{"a1", "b", "a2", "a3"});
+        REQUIRE(dwm.next_deadline() == 2ms);
+    }
+
+    SECTION("Sleeping until the deadline gives the same invocations as ticking")
+    {
+        delayed_work_manager<1> ticked;
+        delayed_work_manager<1> tickless;
+        std::mt19937 gen{1};
+        std::uniform_int_distribution<unsigned> dist{1, 300000};
+        std::vector<std::pair<unsigned, unsigned>> ticked_invocations;
+        std::vector<std::pair<unsigned, unsigned>> tickless_invocations;
+        unsigned ticked_time{0};
+        unsigned tickless_time{0};
+        for (unsigned i = 0; i < 50; ++i)
+        {
+            auto period{dist(gen)};
+            ticked.register_work(period, [&, i]() {
+                ticked_invocations.emplace_back(ticked_time, i);
+                return delayed_work_policy::keep;
+            });
+            tickless.register_work(period, [&, i]() {
+                tickless_invocations.emplace_back(tickless_time, i);
+                return delayed_work_policy::keep;
+            });
+        }
+
+        constexpr unsigned duration{2000000};
+        for (ticked_time = 1; ticked_time <= duration; ++ticked_time)
+            ticked.invoke();
+        while (tickless_time + tickless.next_deadline()->count() <= duration)
+        {
+            tickless_time += tickless.next_deadline()->count();
+            tickless.invoke(*tickless.next_deadline());
+        }
+
+        std::sort(std::begin(ticked_invocations), std::end(ticked_invocations));
+        std::sort(std::begin(tickless_invocations), std::end(tickless_invocations));
+        REQUIRE(ticked_invocations == tickless_invocations);
+    }
+
+    SECTION("Elapsed time can span many deadlines")
+    {
+        delayed_work_manager<1> dwm;
+        unsigned count{0};
+        dwm.register_work(1000, [&]() {
+            ++count;
+            return delayed_work_policy::keep;
+        });
+        dwm.invoke(1u << 25);
+        REQUIRE(count == (1u << 25) / 1000);
+    }
+
+    SECTION("Work due later than two rotations of the wheel is invoked on time")
+    {
+        delayed_work_manager<1> dwm;
+        constexpr unsigned period{(1u << 25) + 100};
+        unsigned count{0};
+        dwm.register_work(period, [&]() {
+            ++count;
+            return delayed_work_policy::keep;
+        });
+        dwm.invoke(1u << 24);
+        REQUIRE(dwm.next_deadline() == std::chrono::milliseconds{period - (1u << 24)});
+        dwm.invoke(period - (1u << 24) - 1);
+        REQUIRE(count == 0);
+        dwm.invoke();
+        REQUIRE(count == 1);
+        dwm.invoke(period);
+        REQUIRE(count == 2);
+    }
+}
+
+TEST_CASE("delayed_work_manager time base", "[delayed_work_manager]")
+{
+    using namespace std::chrono_literals;
+
+    SECTION("Periods can be expressed with std::chrono durations")
+    {
+        delayed_work_manager<10, 0, std::chrono::milliseconds> dwm;
+        std::vector<std::chrono::milliseconds> invoked_at;
+        dwm.register_work(1s, [&]() {
+            invoked_at.push_back(dwm.now());
+            return delayed_work_policy::keep;
+        });
+        dwm.register_work(30ms, [&]() {
+            invoked_at.push_back(dwm.now());
+            return delayed_work_policy::deregister;
+        });
+        dwm.invoke(2s);
+        REQUIRE(dwm.now() == 2s);
+        REQUIRE(invoked_at == std::vector<std::chrono::milliseconds>{30ms, 1s, 2s});
+    }
+
+    SECTION("Time doesn't overflow after 2^32 ticks")
+    {
+        delayed_work_manager<1> dwm;
+        uint64_t count{0};
+        dwm.register_work(1000000, [&]() {
+            ++count;
+            return delayed_work_policy::keep;
+        });
+        for (unsigned i = 0; i < 3; ++i)
+            dwm.invoke(std::numeric_limits<unsigned>::max());
+        REQUIRE(count == 3 * uint64_t{std::numeric_limits<unsigned>::max()} / 1000000);
+        REQUIRE(dwm.next_deadline() ==
+                std::chrono::milliseconds{1000000 - 3 * uint64_t{std::numeric_limits<unsigned>::max()} % 1000000});
+        REQUIRE(dwm.now() == std::chrono::milliseconds{3 * uint64_t{std::numeric_limits<unsigned>::max()}});
+    }
+
+    SECTION("Elapsed time given as a duration isn't limited by the range of unsigned")
+    {
+        delayed_work_manager<1> dwm;
+        uint64_t count{0};
+        dwm.register_work(1000000, [&]() {
+            ++count;
+            return delayed_work_policy::keep;
+        });
+        std::chrono::milliseconds elapsed{3 * uint64_t{std::numeric_limits<unsigned>::max()}};
+        dwm.invoke(elapsed);
+        REQUIRE(count == 3 * uint64_t{std::numeric_limits<unsigned>::max()} / 1000000);
+        REQUIRE(dwm.now() == elapsed);
+    }
+
+    SECTION("Work can be submitted and rescheduled with std::chrono durations")
+    {
+        delayed_work_manager<10> dwm;
+        std::vector<std::chrono::milliseconds> invoked_at;
+        REQUIRE(dwm.submit_work(50ms, [&]() {
+            invoked_at.push_back(dwm.now());
+            return delayed_work_policy::deregister;
+        }));
+        auto h{dwm.register_work(1s, [&]() {
+            invoked_at.push_back(dwm.now());
+            return delayed_work_policy::deregister;
+        })};
+        REQUIRE(h.reschedule(100ms));
+        REQUIRE(dwm.next_deadline() == 100ms);
+        dwm.invoke(200ms);
+        REQUIRE(invoked_at == std::vector<std::chrono::milliseconds>{50ms, 100ms});
+    }
+}
+
+TEST_CASE("delayed_work_manager instrumentation", "[delayed_work_manager]")
+{
+    using instrumented_manager = delayed_work_manager<1, 0, std::chrono::milliseconds, true>;
+    instrumented_manager dwm;
+
+    static_assert(std::is_empty_v<delayed_work_manager_instrumentation<false>>);
+
+    SECTION("Invocations and their lateness are counted for each of the jobs")
+    {
+        auto h{dwm.register_work(2, []() { return delayed_work_policy::keep; })};
+        dwm.invoke(10u);
+        auto stats{h.stats()};
+        REQUIRE(stats.has_value());
+        REQUIRE(stats->num_invocations == 5);
+        REQUIRE(std::accumulate(std::begin(stats->execution_time_histogram),
+                                std::end(stats->execution_time_histogram),
+                                uint64_t{0}) == 5);
+        REQUIRE(stats->total_lateness_ticks == 8 + 6 + 4 + 2);
+        REQUIRE(stats->max_lateness_ticks == 8);
+
+        dwm.invoke();
+        dwm.invoke();
+        REQUIRE(h.stats()->num_invocations == 6);
+        REQUIRE(h.stats()->total_lateness_ticks == 20);
+        REQUIRE(dwm.stats().num_ticks == 5 + 2);
+    }
+
+    SECTION("Ticks in which the handlers took longer than the invocation period are counted")
+    {
+        auto h{dwm.register_work(2, []() {
+            std::this_thread::sleep_for(std::chrono::milliseconds(3));
+            return delayed_work_policy::keep;
+        })};
+        dwm.invoke();
+        REQUIRE(dwm.stats().num_overrun_ticks == 0);
+        dwm.invoke();
+        REQUIRE(dwm.stats().num_overrun_ticks == 1);
+        REQUIRE(dwm.stats().max_tick_execution_time >= std::chrono::milliseconds(3));
+
+        auto stats{*h.stats()};
+        REQUIRE(stats.max_execution_time >= std::chrono::milliseconds(3));
+
+        // At least 3 ms falls into the bucket of [2048, 4096) us or to the later ones.
+        auto bucket_2048_us{std::next(std::begin(stats.execution_time_histogram), 12)};
+        REQUIRE(std::accumulate(bucket_2048_us, std::end(stats.execution_time_histogram), uint64_t{0}) == 1);
+    }
+
+    SECTION("There are no statistics of a deregistered job")
+    {
+        auto h{dwm.register_work(1, []() { return delayed_work_policy::deregister; })};
+        dwm.invoke();
+        REQUIRE_FALSE(h.stats().has_value());
+    }
+}
+
+static void benchmark_invoke(unsigned num_timers)
+{
+    delayed_work_manager<1> dwm;
+    std::mt19937 gen{1};
+    std::uniform_int_distribution<unsigned> dist{1, 100000};
+    unsigned count{0};
+    for (unsigned i = 0; i < num_timers; ++i)
+        dwm.register_work(dist(gen), [&]() {
+            ++count;
+            return delayed_work_policy::keep;
+        });
+
+    BENCHMARK(std::to_string(num_timers) + " timers, invoke()")
+    {
+        dwm.invoke();
+        return count;
+    };
+}
+
+TEST_CASE("delayed_work_manager invoke() benchmark", "[delayed_work_manager][!benchmark]")
+{
+    benchmark_invoke(1000);
+    benchmark_invoke(100000);
+    benchmark_invoke(1000000);
+}
@@ -15,10 +15,29 @@ static void UNIT_TEST_1_raise_no_handler_registered();
 static void UNIT_TEST_2_raise_single_handler_registered();
 static void UNIT_TEST_3_raise_multiple_handlers_registered();
 static void GIVEN_multiple_handlers_reged_WHEN_raised_AND_WHEN_one_policy_deregister_THEN_deregistered();
+static void GIVEN_handlers_deregistering_in_turns_WHEN_raised_THEN_remaining_invoked_in_registration_order();
+static void GIVEN_handler_registering_handler_WHEN_raised_THEN_registered_handler_invoked_from_next_raise();
+static void GIVEN_payload_handlers_WHEN_raised_THEN_all_get_the_same_payload_object();
+static void GIVEN_const_payload_handlers_WHEN_raised_with_temporaries_THEN_handlers_get_the_values();
+static void GIVEN_handler_deregistered_with_token_WHEN_raised_THEN_not_invoked_AND_token_stale();
+static void GIVEN_handler_deregistering_next_handler_WHEN_raised_THEN_next_handler_not_invoked();
+static void GIVEN_handlers_of_different_priorities_WHEN_raised_THEN_invoked_by_priority_then_registration_order();
+static void GIVEN_handler_throwing_WHEN_raised_THEN_handler_registered_later_invoked_from_next_raise();
 
 // --------------------------------------------------------------------------------------------------------------------
 // DECLARATION OF PRIVATE FUNCTIONS AND VARIABLES
 // --------------------------------------------------------------------------------------------------------------------
+struct noncopyable_payload
+{
+    unsigned value;
+
+    explicit noncopyable_payload(unsigned v) : value{v}
+    {
+    }
+
+    noncopyable_payload(const noncopyable_payload &) = delete;
+    noncopyable_payload &operator=(const noncopyable_payload &) = delete;
+};
 
 // --------------------------------------------------------------------------------------------------------------------
 // EXECUTION OF THE TESTS
@@ -29,6 +48,14 @@ void test_event_handler()
     RUN_TEST(UNIT_TEST_2_raise_single_handler_registered);
     RUN_TEST(UNIT_TEST_3_raise_multiple_handlers_registered);
     RUN_TEST(GIVEN_multiple_handlers_reged_WHEN_raised_AND_WHEN_one_policy_deregister_THEN_deregistered);
+    RUN_TEST(GIVEN_handlers_deregistering_in_turns_WHEN_raised_THEN_remaining_invoked_in_registration_order);
+    RUN_TEST(GIVEN_handler_registering_handler_WHEN_raised_THEN_registered_handler_invoked_from_next_raise);
+    RUN_TEST(GIVEN_payload_handlers_WHEN_raised_THEN_all_get_the_same_payload_object);
+    RUN_TEST(GIVEN_const_payload_handlers_WHEN_raised_with_temporaries_THEN_handlers_get_the_values);
+    RUN_TEST(GIVEN_handler_deregistered_with_token_WHEN_raised_THEN_not_invoked_AND_token_stale);
+    RUN_TEST(GIVEN_handler_deregistering_next_handler_WHEN_raised_THEN_next_handler_not_invoked);
+    RUN_TEST(GIVEN_handlers_of_different_priorities_WHEN_raised_THEN_invoked_by_priority_then_registration_order);
+    RUN_TEST(GIVEN_handler_throwing_WHEN_raised_THEN_handler_registered_later_invoked_from_next_raise);
 }
 
 // --------------------------------------------------------------------------------------------------------------------
@@ -90,6 +117,196 @@ static void GIVEN_multiple_handlers_reged_WHEN_raised_AND_WHEN_one_policy_deregi
     TEST_ASSERT_EQUAL_UINT(1 | 4, res);
 }
 
+static void GIVEN_handlers_deregistering_in_turns_WHEN_raised_THEN_remaining_invoked_in_registration_order()
+{
+    event_handler eh;
+    unsigned order[8];
+    unsigned num_invoked = 0;
+    unsigned raise_count = 0;
+    for (unsigned i = 0; i < 8; ++i)
+    {
+        // The handler i is invoked i + 1 times.
+        eh.register_handler([&, i]() {
+            order[num_invoked++] = i;
+            return raise_count == i ? event_handler::policy::deregister : event_handler::policy::keep;
+        });
+    }
+    for (raise_count = 0; raise_count < 5; ++raise_count)
+    {
+        num_invoked = 0;
+        eh.raise();
+        TEST_ASSERT_EQUAL_UINT(8 - raise_count, num_invoked);
+        for (unsigned i = 0; i < num_invoked; ++i)
+            TEST_ASSERT_EQUAL_UINT(raise_count + i, order[i]);
+    }
+}
+
+static void GIVEN_handler_registering_handler_WHEN_raised_THEN_registered_handler_invoked_from_next_raise()
+{
+    event_handler eh;
+    unsigned res = 0;
+    eh.register_handler([&]() {
+        res |= 1;
+        eh.register_handler([&res]() {
+            res |= 2;
+            return event_handler::policy::keep;
+        });
+        return event_handler::policy::deregister;
+    });
+    eh.raise();
+    TEST_ASSERT_EQUAL_UINT(1, res);
+    res = 0;
+    eh.raise();
+    TEST_ASSERT_EQUAL_UINT(2, res);
+    res = 0;
+    eh.raise();
+    TEST_ASSERT_EQUAL_UINT(2, res);
+}
+
+static void GIVEN_payload_handlers_WHEN_raised_THEN_all_get_the_same_payload_object()
+{
+    using handler = basic_event_handler<noncopyable_payload, unsigned>;
+    handler eh;
+    const noncopyable_payload *seen[2] = {nullptr, nullptr};
+    for (unsigned i = 0; i < 2; ++i)
+    {
+        eh.register_handler([&seen, i](noncopyable_payload &p, unsigned &increment) {
+            seen[i] = &p;
+            p.value += increment;
+            return handler::policy::keep;
+        });
+    }
+    noncopyable_payload payload{1};
+    unsigned increment = 10;
+    eh.raise(payload, increment);
+    TEST_ASSERT_EQUAL_PTR(&payload, seen[0]);
+    TEST_ASSERT_EQUAL_PTR(&payload, seen[1]);
+    TEST_ASSERT_EQUAL_UINT(21, payload.value);
+}
+
+static void GIVEN_const_payload_handlers_WHEN_raised_with_temporaries_THEN_handlers_get_the_values()
+{
+    using handler = basic_event_handler<const unsigned, const noncopyable_payload>;
+    handler eh;
+    unsigned res = 0;
+    eh.register_handler([&res](const unsigned &a, const noncopyable_payload &p) {
+        res = a + p.value;
+        return handler::policy::deregister;
+    });
+    eh.raise(3u, noncopyable_payload{4});
+    TEST_ASSERT_EQUAL_UINT(7, res);
+    res = 0;
+    eh.raise(3u, noncopyable_payload{4});
+    TEST_ASSERT_EQUAL_UINT(0, res);
+}
+
+static void GIVEN_handler_deregistered_with_token_WHEN_raised_THEN_not_invoked_AND_token_stale()
+{
+    event_handler eh;
+    unsigned res = 0;
+    auto t1 = eh.register_handler([&res]() {
+        res |= 1;
+        return event_handler::policy::keep;
+    });
+    eh.register_handler([&res]() {
+        res |= 2;
+        return event_handler::policy::keep;
+    });
+    TEST_ASSERT_TRUE(eh.deregister_handler(t1));
+    TEST_ASSERT_FALSE(eh.deregister_handler(t1));
+    eh.raise();
+    TEST_ASSERT_EQUAL_UINT(2, res);
+
+    // The id of the first handler is reused, but the stale token doesn't deregister the new handler.
+    auto t3 = eh.register_handler([&res]() {
+        res |= 4;
+        return event_handler::policy::keep;
+    });
+    TEST_ASSERT_EQUAL_UINT(t1.id, t3.id);
+    TEST_ASSERT_FALSE(eh.deregister_handler(t1));
+    res = 0;
+    eh.raise();
+    TEST_ASSERT_EQUAL_UINT(6, res);
+}
+
+static void GIVEN_handler_deregistering_next_handler_WHEN_raised_THEN_next_handler_not_invoked()
+{
+    event_handler eh;
+    unsigned res = 0;
+    event_handler::token t2;
+    eh.register_handler([&]() {
+        res |= 1;
+        eh.deregister_handler(t2);
+        return event_handler::policy::keep;
+    });
+    t2 = eh.register_handler([&res]() {
+        res |= 2;
+        return event_handler::policy::keep;
+    });
+    eh.raise();
+    TEST_ASSERT_EQUAL_UINT(1, res);
+}
+
+static void GIVEN_handlers_of_different_priorities_WHEN_raised_THEN_invoked_by_priority_then_registration_order()
+{
+    event_handler eh;
+    unsigned order[5];
+    unsigned num_invoked = 0;
+    auto reg{[&](unsigned id, event_handler::priority prio) {
+        eh.register_handler(
+            [&, id]() {
+                order[num_invoked++] = id;
+                return event_handler::policy::keep;
+            },
+            prio);
+    }};
+    reg(3, event_handler::priority::low);
+    reg(1, event_handler::priority::normal);
+    reg(0, event_handler::priority::critical);
+    reg(2, event_handler::priority::normal);
+    eh.register_handler([&]() {
+        order[num_invoked++] = 4;
+        return event_handler::policy::deregister;
+    });
+    eh.raise();
+    TEST_ASSERT_EQUAL_UINT(5, num_invoked);
+    TEST_ASSERT_EQUAL_UINT(0, order[0]);
+    TEST_ASSERT_EQUAL_UINT(1, order[1]);
+    TEST_ASSERT_EQUAL_UINT(2, order[2]);
+    TEST_ASSERT_EQUAL_UINT(4, order[3]);
+    TEST_ASSERT_EQUAL_UINT(3, order[4]);
+}
+
+static void GIVEN_handler_throwing_WHEN_raised_THEN_handler_registered_later_invoked_from_next_raise()
+{
+    event_handler eh;
+    bool has_thrown = false;
+    unsigned num_invoked = 0;
+    eh.register_handler([&has_thrown]() {
+        if (!has_thrown)
+        {
+            has_thrown = true;
+            throw 1;
+        }
+        return event_handler::policy::deregister;
+    });
+    try
+    {
+        eh.raise();
+    }
+    catch (int)
+    {
+    }
+    TEST_ASSERT_TRUE(has_thrown);
+
+    eh.register_handler([&num_invoked]() {
+        ++num_invoked;
+        return event_handler::policy::keep;
+    });
+    eh.raise();
+    TEST_ASSERT_EQUAL_UINT(1, num_invoked);
+}
+
 // --------------------------------------------------------------------------------------------------------------------
 // DEFINITION OF PRIVATE FUNCTIONS
 // --------------------------------------------------------------------------------------------------------------------
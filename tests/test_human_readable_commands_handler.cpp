@@ -0,0 +1,67 @@
+/**
+ * @file	test_human_readable_commands_handler.cpp
+ * @brief	Tests the human_readable_commands_handler template class.
+ * @author	Kacper Kowalski - kacper.s.kowalski@gmail.com
+ */
+#include "ext_deps/catch/catch.hpp"
+
+#include "human_readable_commands_handler.hpp"
+
+#include <cstring>
+#include <string>
+
+template <size_t N> static void push_command(human_readable_commands_handler<N> &h, const std::string &s)
+{
+    for (auto c : s)
+        h.push_elem_and_check_command_end(c);
+}
+
+TEST_CASE("human_readable_commands_handler template class unit tests", "[human_readable_commands_handler]")
+{
+    human_readable_commands_handler<16> h;
+
+    SECTION("Pops the command into a string, skipping the empty commands")
+    {
+        std::string s;
+        push_command(h, "\r\r\nAT\r\n\rOK\r");
+        REQUIRE(h.pop_string_into(s));
+        REQUIRE(s == "AT");
+        REQUIRE(h.pop_string_into(s));
+        REQUIRE(s == "OK");
+
+        push_command(h, "\r\r");
+        REQUIRE_FALSE(h.pop_string_into(s));
+        REQUIRE(s == "OK");
+        REQUIRE(h.pop_command().empty());
+    }
+
+    SECTION("Pops the command wrapping around the end of the buffer")
+    {
+        std::string s;
+        s.reserve(32);
+        auto data{s.data()};
+
+        push_command(h, "ABCDEFGHIJ\r\n");
+        REQUIRE(h.pop_string_into(s));
+        REQUIRE(s == "ABCDEFGHIJ");
+        push_command(h, "KLMNOPQRS\r\n");
+        REQUIRE(h.pop_string_into(s));
+        REQUIRE(s == "KLMNOPQRS");
+        REQUIRE(s.data() == data);
+    }
+
+    SECTION("Pops the command into a buffer, truncating it")
+    {
+        char buf[8];
+        push_command(h, "ABCDEFGHIJ\r");
+        REQUIRE(h.pop_command() == "ABCDEFGHIJ");
+        push_command(h, "\rKLMNOPQRS\r\rTUV\r");
+
+        REQUIRE(h.pop_into(buf, sizeof(buf)) == 9);
+        REQUIRE(std::strcmp(buf, "KLMNOPQ") == 0);
+        REQUIRE(h.pop_into(buf, sizeof(buf)) == 3);
+        REQUIRE(std::strcmp(buf, "TUV") == 0);
+        REQUIRE(h.pop_into(buf, sizeof(buf)) == 0);
+        REQUIRE(std::strcmp(buf, "TUV") == 0);
+    }
+}
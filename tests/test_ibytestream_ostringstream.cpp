@@ -6,6 +6,8 @@
 #include "ibytestream_ostringstream.hpp"
 #include "unity.h"
 
+#include <random>
+
 using namespace jungles;
 
 // --------------------------------------------------------------------------------------------------------------------
@@ -24,6 +26,16 @@ static void UNIT_TEST_push_exceptional_character_and_newline_after_that();
 static void UNIT_TEST_push_exceptional_character_in_the_middle_of_the_string();
 static void UNIT_TEST_push_string_with_multiple_different_exceptional_characters();
 static void UNIT_TEST_push_string_finished_with_exceptional_character_then_next_string();
+static void UNIT_TEST_push_bytes_returns_number_of_completed_strings();
+static void UNIT_TEST_push_bytes_completes_string_started_by_previous_push();
+static void UNIT_TEST_push_bytes_with_many_terminators();
+static void UNIT_TEST_push_bytes_in_random_chunks_same_as_push_byte();
+static void UNIT_TEST_push_bytes_longer_than_internal_buffer_same_as_push_byte();
+static void UNIT_TEST_peek_string_and_release();
+static void UNIT_TEST_peek_string_wrapping_around_buffer_end();
+static void UNIT_TEST_peek_string_and_release_when_empty();
+static void UNIT_TEST_pop_string_into_reuses_string();
+static void UNIT_TEST_pop_into_buffer();
 
 // --------------------------------------------------------------------------------------------------------------------
 // DECLARATION OF PRIVATE FUNCTIONS AND VARIABLES
@@ -52,6 +64,16 @@ void test_ibytestream_ostringstream()
     RUN_TEST(UNIT_TEST_push_exceptional_character_in_the_middle_of_the_string);
     RUN_TEST(UNIT_TEST_push_string_with_multiple_different_exceptional_characters);
     RUN_TEST(UNIT_TEST_push_string_finished_with_exceptional_character_then_next_string);
+    RUN_TEST(UNIT_TEST_push_bytes_returns_number_of_completed_strings);
+    RUN_TEST(UNIT_TEST_push_bytes_completes_string_started_by_previous_push);
+    RUN_TEST(UNIT_TEST_push_bytes_with_many_terminators);
+    RUN_TEST(UNIT_TEST_push_bytes_in_random_chunks_same_as_push_byte);
+    RUN_TEST(UNIT_TEST_push_bytes_longer_than_internal_buffer_same_as_push_byte);
+    RUN_TEST(UNIT_TEST_peek_string_and_release);
+    RUN_TEST(UNIT_TEST_peek_string_wrapping_around_buffer_end);
+    RUN_TEST(UNIT_TEST_peek_string_and_release_when_empty);
+    RUN_TEST(UNIT_TEST_pop_string_into_reuses_string);
+    RUN_TEST(UNIT_TEST_pop_into_buffer);
 }
 
 // --------------------------------------------------------------------------------------------------------------------
@@ -210,6 +232,168 @@ static void UNIT_TEST_push_string_finished_with_exceptional_character_then_next_
     TEST_ASSERT_EQUAL_STRING(expected2.c_str(), b.pop_string().c_str());
 }
 
+static void UNIT_TEST_push_bytes_returns_number_of_completed_strings()
+{
+    ibytestream_ostringstream<64, 16> b(">");
+
+    TEST_ASSERT_EQUAL_UINT(4, b.push_bytes(std::string_view{"AT\r\n\n>OK>\0>ERR", 14}));
+    TEST_ASSERT_EQUAL_STRING("AT", b.pop_string().c_str());
+    TEST_ASSERT_EQUAL_STRING(">", b.pop_string().c_str());
+    TEST_ASSERT_EQUAL_STRING("OK>", b.pop_string().c_str());
+    TEST_ASSERT_EQUAL_STRING(">", b.pop_string().c_str());
+    TEST_ASSERT(b.is_empty() == true);
+    TEST_ASSERT_EQUAL_UINT(0, b.push_bytes(""));
+}
+
+static void UNIT_TEST_push_bytes_completes_string_started_by_previous_push()
+{
+    ibytestream_ostringstream<64, 16> b;
+
+    TEST_ASSERT_EQUAL_UINT(0, b.push_bytes("SAN"));
+    TEST_ASSERT(b.push_byte_and_is_string_end('T') == false);
+    TEST_ASSERT_EQUAL_UINT(1, b.push_bytes("IAGO\r\nBILB"));
+    TEST_ASSERT_EQUAL_STRING("SANTIAGO", b.pop_string().c_str());
+    TEST_ASSERT(b.is_empty() == true);
+    TEST_ASSERT_EQUAL_UINT(1, b.push_bytes("AO\n"));
+    TEST_ASSERT_EQUAL_STRING("BILBAO", b.pop_string().c_str());
+}
+
+static void UNIT_TEST_push_bytes_with_many_terminators()
+{
+    ibytestream_ostringstream<64, 16> b("", ";,.:/|");
+
+    TEST_ASSERT_EQUAL_UINT(5, b.push_bytes("A;B,,C.D:E|F"));
+    for (auto expected : {"A", "B", "C", "D", "E"})
+        TEST_ASSERT_EQUAL_STRING(expected, b.pop_string().c_str());
+    TEST_ASSERT(b.is_empty() == true);
+}
+
+static void UNIT_TEST_push_bytes_in_random_chunks_same_as_push_byte()
+{
+    // The strings wrap around the internal buffer many times.
+    ibytestream_ostringstream<64, 16> by_byte(">?"), by_chunk(">?");
+    std::minstd_rand gen;
+    const char alphabet[] = {'A', 'B', 'C', '>', '?', '\r', '\n', '\0'};
+    std::string chunk;
+
+    for (unsigned i = 0; i < 2000; ++i)
+    {
+        chunk.clear();
+        auto len{gen() % 24};
+        for (unsigned j = 0; j < len; ++j)
+            chunk.push_back(alphabet[gen() % sizeof(alphabet)]);
+
+        unsigned num_by_byte = 0;
+        for (auto c : chunk)
+            num_by_byte += by_byte.push_byte_and_is_string_end(c);
+        TEST_ASSERT_EQUAL_UINT(num_by_byte, by_chunk.push_bytes(chunk));
+
+        while (!by_byte.is_empty())
+            TEST_ASSERT_EQUAL_STRING(by_byte.pop_string().c_str(), by_chunk.pop_string().c_str());
+        TEST_ASSERT(by_chunk.is_empty() == true);
+    }
+}
+
+static void UNIT_TEST_push_bytes_longer_than_internal_buffer_same_as_push_byte()
+{
+    // Both the chunk and its first line overflow the internal buffer.
+    ibytestream_ostringstream<16, 4> by_byte, by_chunk;
+    std::string chunk(100, 'a');
+    chunk += "\nOK\n";
+
+    unsigned num_by_byte = 0;
+    for (auto c : chunk)
+        num_by_byte += by_byte.push_byte_and_is_string_end(c);
+    TEST_ASSERT_EQUAL_UINT(num_by_byte, by_chunk.push_bytes(chunk));
+
+    while (!by_byte.is_empty())
+        TEST_ASSERT_EQUAL_STRING(by_byte.pop_string().c_str(), by_chunk.pop_string().c_str());
+    TEST_ASSERT(by_chunk.is_empty() == true);
+
+    TEST_ASSERT_EQUAL_UINT(1, by_chunk.push_bytes("MADRID\n"));
+    TEST_ASSERT_EQUAL_STRING("MADRID", by_chunk.pop_string().c_str());
+}
+
+static void UNIT_TEST_peek_string_and_release()
+{
+    ibytestream_ostringstream<64, 16> b;
+    b.push_bytes("MADRID\nSEVILLA\n");
+
+    auto v{b.peek_string()};
+    TEST_ASSERT(v.first == "MADRID");
+    TEST_ASSERT(v.second.empty());
+    TEST_ASSERT(b.peek_string().first == "MADRID");
+
+    b.release();
+    TEST_ASSERT(b.peek_string().first == "SEVILLA");
+    TEST_ASSERT_EQUAL_STRING("SEVILLA", b.pop_string().c_str());
+    TEST_ASSERT(b.is_empty() == true);
+}
+
+static void UNIT_TEST_peek_string_wrapping_around_buffer_end()
+{
+    ibytestream_ostringstream<16, 4> b;
+    b.push_bytes("0123456789\n");
+    b.release();
+
+    b.push_bytes("ABCDEFGHIJ\n");
+    auto v{b.peek_string()};
+    TEST_ASSERT_EQUAL_UINT(10, v.size());
+    TEST_ASSERT(v.first == "ABCDEF");
+    TEST_ASSERT(v.second == "GHIJ");
+
+    b.release();
+    TEST_ASSERT(b.is_empty() == true);
+    b.push_bytes("KLM\n");
+    TEST_ASSERT(b.peek_string().first == "KLM");
+}
+
+static void UNIT_TEST_peek_string_and_release_when_empty()
+{
+    ibytestream_ostringstream<64, 16> b;
+    b.push_bytes("UNFINISHED");
+    TEST_ASSERT(b.peek_string().empty());
+    b.release();
+    b.push_bytes("\n");
+    TEST_ASSERT_EQUAL_STRING("UNFINISHED", b.pop_string().c_str());
+}
+
+static void UNIT_TEST_pop_string_into_reuses_string()
+{
+    ibytestream_ostringstream<16, 4> b;
+    std::string s;
+    s.reserve(32);
+    auto data{s.data()};
+
+    TEST_ASSERT(b.pop_string_into(s) == false);
+    for (auto line : {"GRANADA\n", "VALENCIA\n", "MALAGA\n"})
+    {
+        b.push_bytes(line);
+        TEST_ASSERT(b.pop_string_into(s) == true);
+        TEST_ASSERT(s + "\n" == line);
+        TEST_ASSERT(s.data() == data);
+    }
+    TEST_ASSERT(b.is_empty() == true);
+}
+
+static void UNIT_TEST_pop_into_buffer()
+{
+    ibytestream_ostringstream<16, 4> b;
+    char buf[8];
+
+    TEST_ASSERT_EQUAL_UINT(0, b.pop_into(buf, sizeof(buf)));
+
+    b.push_bytes("0123456789\n");
+    TEST_ASSERT_EQUAL_UINT(10, b.pop_into(buf, sizeof(buf)));
+    TEST_ASSERT_EQUAL_STRING("0123456", buf);
+
+    // Wraps around the end of the internal buffer.
+    b.push_bytes("ABCDEFG\n");
+    TEST_ASSERT_EQUAL_UINT(7, b.pop_into(buf, sizeof(buf)));
+    TEST_ASSERT_EQUAL_STRING("ABCDEFG", buf);
+    TEST_ASSERT(b.is_empty() == true);
+}
+
 // --------------------------------------------------------------------------------------------------------------------
 // DEFINITION OF PRIVATE FUNCTIONS
 // --------------------------------------------------------------------------------------------------------------------
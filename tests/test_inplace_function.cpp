@@ -0,0 +1,162 @@
+/**
+ * @file	test_inplace_function.cpp
+ * @brief	Tests the inplace_function template class.
+ * @author	Kacper Kowalski - kacper.s.kowalski@gmail.com
+ */
+#include "ext_deps/catch/catch.hpp"
+
+#include "inplace_function.hpp"
+
+#include <array>
+#include <memory>
+#include <string>
+
+using jungles::inplace_function;
+
+TEST_CASE("inplace_function template class unit tests", "[inplace_function]")
+{
+    SECTION("Default constructed is empty")
+    {
+        inplace_function<void(void)> f;
+        REQUIRE_FALSE(f);
+        inplace_function<void(void)> g{nullptr};
+        REQUIRE_FALSE(g);
+    }
+
+    SECTION("Calls a free function")
+    {
+        struct math
+        {
+            static int twice(int v)
+            {
+                return 2 * v;
+            }
+        };
+        inplace_function<int(int)> f{&math::twice};
+        REQUIRE(f);
+        REQUIRE(f(21) == 42);
+    }
+
+    SECTION("Calls a capturing lambda and passes the arguments")
+    {
+        int offset{10};
+        std::string s{"abc"};
+        inplace_function<std::size_t(const std::string &, int)> f{
+            [offset, &s](const std::string &in, int v) { return in.size() + s.size() + offset + v; }};
+        REQUIRE(f("de", 1) == 16);
+    }
+
+    SECTION("Calls a mutable lambda which keeps its state")
+    {
+        inplace_function<int(void)> f{[cnt = 0]() mutable { return ++cnt; }};
+        REQUIRE(f() == 1);
+        REQUIRE(f() == 2);
+        REQUIRE(f() == 3);
+    }
+
+    SECTION("Copies the callable")
+    {
+        inplace_function<int(void)> f{[cnt = 0]() mutable { return ++cnt; }};
+        f();
+        auto g{f};
+        REQUIRE(f() == 2);
+        REQUIRE(g() == 2);
+        REQUIRE(g() == 3);
+
+        inplace_function<int(void)> h;
+        h = g;
+        REQUIRE(h() == 4);
+        REQUIRE(g() == 4);
+    }
+
+    SECTION("Moves the callable")
+    {
+        inplace_function<int(void)> f{[cnt = 0]() mutable { return ++cnt; }};
+        f();
+        auto g{std::move(f)};
+        REQUIRE(g() == 2);
+
+        inplace_function<int(void)> h{[]() { return 0; }};
+        h = std::move(g);
+        REQUIRE(h() == 3);
+    }
+
+    SECTION("Destroys the callable exactly once")
+    {
+        auto resource{std::make_shared<int>(5)};
+        {
+            inplace_function<int(void)> f{[resource]() { return *resource; }};
+            REQUIRE(resource.use_count() == 2);
+
+            auto g{f};
+            REQUIRE(resource.use_count() == 3);
+
+            auto h{std::move(g)};
+            REQUIRE(resource.use_count() == 3);
+            REQUIRE(h() == 5);
+
+            h = nullptr;
+            REQUIRE(resource.use_count() == 2);
+
+            f = inplace_function<int(void)>{[]() { return 0; }};
+            REQUIRE(resource.use_count() == 1);
+        }
+        REQUIRE(resource.use_count() == 1);
+    }
+
+    SECTION("Moving leaves the source empty and keeps the number of live callables")
+    {
+        struct counted
+        {
+            int *live;
+
+            explicit counted(int *live) : live{live}
+            {
+                ++*live;
+            }
+            counted(const counted &other) : live{other.live}
+            {
+                ++*live;
+            }
+            counted(counted &&other) noexcept : live{other.live}
+            {
+                ++*live;
+            }
+            ~counted()
+            {
+                --*live;
+            }
+            int operator()() const
+            {
+                return *live;
+            }
+        };
+
+        int live{0};
+        {
+            inplace_function<int(void)> f{counted{&live}};
+            REQUIRE(live == 1);
+
+            auto g{std::move(f)};
+            REQUIRE(live == 1);
+            REQUIRE_FALSE(f);
+            REQUIRE(g);
+            REQUIRE(g() == 1);
+
+            inplace_function<int(void)> h{[]() { return 0; }};
+            h = std::move(g);
+            REQUIRE(live == 1);
+            REQUIRE_FALSE(g);
+            REQUIRE(h() == 1);
+        }
+        REQUIRE(live == 0);
+    }
+
+    SECTION("Accepts callables as big as the capacity")
+    {
+        std::array<char, 100> big{};
+        big[99] = 7;
+        inplace_function<int(void), sizeof(big)> f{[big]() { return big[99]; }};
+        REQUIRE(f() == 7);
+    }
+}
@@ -0,0 +1,137 @@
+/**
+ * @file	test_runtime_boundary_mapper.cpp
+ * @brief	Tests the runtime_boundary_mapper template class
+ * @author	Kacper Kowalski - kacper.s.kowalski@gmail.com
+ */
+#include "ext_deps/catch/catch.hpp"
+
+#include "runtime_boundary_mapper.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <limits>
+#include <thread>
+#include <vector>
+
+enum class test_level : unsigned
+{
+};
+
+static bool is_same_as_lower_bound(const jungles::runtime_boundary_mapper<test_level, int> &mapper,
+                                   const std::vector<int> &boundaries)
+{
+    for (int v = boundaries.front() - 10; v < boundaries.back() + 10; ++v)
+    {
+        auto expected{std::lower_bound(std::begin(boundaries), std::end(boundaries), v) - std::begin(boundaries)};
+        if (static_cast<std::ptrdiff_t>(mapper.convert(v)) != expected)
+            return false;
+    }
+    return true;
+}
+
+static std::vector<int> make_boundaries(int count)
+{
+    std::vector<int> res;
+    for (int i = 0; i < count; ++i)
+        res.push_back(10 * i - 100);
+    return res;
+}
+
+TEST_CASE("runtime_boundary_mapper template class unit tests", "[runtime_boundary_mapper]")
+{
+    SECTION("Maps values the same way as boundary_mapper")
+    {
+        jungles::runtime_boundary_mapper<test_level, int> bm{1, 2, 3, 5, 7};
+        REQUIRE(bm.convert(0) == test_level{0});
+        REQUIRE(bm.convert(1) == test_level{0});
+        REQUIRE(bm.convert(2) == test_level{1});
+        REQUIRE(bm.convert(4) == test_level{3});
+        REQUIRE(bm.convert(7) == test_level{4});
+        REQUIRE(bm.convert(8) == test_level{5});
+    }
+
+    SECTION("Works for small and big sets of boundaries")
+    {
+        for (auto count : {1, 7, 100, 2000})
+        {
+            auto boundaries{make_boundaries(count)};
+            jungles::runtime_boundary_mapper<test_level, int> bm{std::begin(boundaries), std::end(boundaries)};
+            REQUIRE(is_same_as_lower_bound(bm, boundaries));
+        }
+    }
+
+    SECTION("Reloads the boundaries")
+    {
+        jungles::runtime_boundary_mapper<test_level, int> bm{10, 20};
+        REQUIRE(bm.convert(15) == test_level{1});
+        REQUIRE(bm.reload({1, 2, 3}));
+        REQUIRE(bm.convert(15) == test_level{3});
+
+        auto boundaries{make_boundaries(2000)};
+        REQUIRE(bm.reload(std::begin(boundaries), std::end(boundaries)));
+        REQUIRE(is_same_as_lower_bound(bm, boundaries));
+    }
+
+    SECTION("Rejects invalid boundaries and keeps the current ones")
+    {
+        jungles::runtime_boundary_mapper<test_level, int> bm{10, 20};
+        REQUIRE_FALSE(bm.reload({}));
+        REQUIRE_FALSE(bm.reload({3, 2, 1}));
+        REQUIRE_FALSE(bm.reload({1, 1}));
+        REQUIRE(bm.convert(15) == test_level{1});
+
+        REQUIRE(bm.is_loaded());
+
+        const float with_nan[]{1.0f, std::numeric_limits<float>::quiet_NaN()};
+        REQUIRE_FALSE(
+            jungles::runtime_boundary_mapper<test_level, float>::is_valid(std::begin(with_nan), std::end(with_nan)));
+    }
+
+    SECTION("Loads nothing when constructed with invalid boundaries")
+    {
+        const int unsorted[]{20, 10};
+        jungles::runtime_boundary_mapper<test_level, int> bm(std::begin(unsorted), std::end(unsorted));
+        REQUIRE_FALSE(bm.is_loaded());
+        REQUIRE(bm.convert(15) == test_level{0});
+
+        jungles::runtime_boundary_mapper<test_level, int> empty(std::initializer_list<int>{});
+        REQUIRE_FALSE(empty.is_loaded());
+
+        REQUIRE(bm.reload({10, 20}));
+        REQUIRE(bm.is_loaded());
+        REQUIRE(bm.convert(15) == test_level{1});
+    }
+
+    SECTION("Readers always see one whole set of boundaries while reloading")
+    {
+        // For 50 the first set gives 3 and the second set gives 0.
+        const std::vector<int> first{10, 20, 30};
+        const std::vector<int> second{100, 200, 300};
+        jungles::runtime_boundary_mapper<test_level, int> bm{std::begin(first), std::end(first)};
+
+        std::atomic<bool> stop{false};
+        std::atomic<bool> is_result_valid{true};
+        std::vector<std::thread> readers;
+        for (unsigned i = 0; i < 3; ++i)
+            readers.emplace_back([&]() {
+                while (!stop)
+                {
+                    auto res{bm.convert(50)};
+                    if (res != test_level{3} && res != test_level{0})
+                        is_result_valid = false;
+                }
+            });
+
+        for (unsigned i = 0; i < 1000; ++i)
+        {
+            const auto &boundaries{i % 2 ? first : second};
+            REQUIRE(bm.reload(std::begin(boundaries), std::end(boundaries)));
+        }
+        stop = true;
+        for (auto &t : readers)
+            t.join();
+
+        REQUIRE(is_result_valid);
+        REQUIRE(bm.convert(50) == test_level{3});
+    }
+}
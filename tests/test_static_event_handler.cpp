@@ -0,0 +1,61 @@
+/**
+ * @file	test_static_event_handler.cpp
+ * @brief	Tests the static_event_handler class.
+ * @author	Kacper Kowalski - kacper.s.kowalski@gmail.com
+ */
+#include "ext_deps/catch/catch.hpp"
+
+#include "event_handler.hpp"
+#include "static_event_handler.hpp"
+
+#include <string>
+
+namespace {
+
+struct button
+{
+    std::string log;
+    unsigned num_presses{0};
+
+    void on_press(unsigned id)
+    {
+        log += "button" + std::to_string(id) + ";";
+    }
+};
+
+void count_press(button &b, unsigned)
+{
+    ++b.num_presses;
+}
+
+jungles::event_handler::policy log_press(button &b, unsigned &id)
+{
+    b.log += "press" + std::to_string(id++) + ";";
+    return jungles::event_handler::policy::deregister;
+}
+
+} // namespace
+
+TEST_CASE("static_event_handler class unit tests", "[static_event_handler]")
+{
+    SECTION("Handlers are invoked in order with the same arguments")
+    {
+        jungles::static_event_handler<&button::on_press, &count_press, &log_press, &button::on_press> eh;
+        button b;
+        unsigned id{1};
+        eh.raise(b, id);
+        REQUIRE(b.log == "button1;press1;button2;");
+        REQUIRE(b.num_presses == 1);
+        REQUIRE(id == 2);
+
+        // The handlers are never deregistered.
+        eh.raise(b, 7u);
+        REQUIRE(b.num_presses == 2);
+    }
+
+    SECTION("No handlers")
+    {
+        jungles::static_event_handler<> eh;
+        eh.raise();
+    }
+}
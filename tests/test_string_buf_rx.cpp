@@ -0,0 +1,85 @@
+/**
+ * @file	test_string_buf_rx.cpp
+ * @brief	Tests the string_buf_rx template class.
+ * @author	Kacper Kowalski - kacper.s.kowalski@gmail.com
+ */
+#include "ext_deps/catch/catch.hpp"
+
+#include "string_buf_rx.hpp"
+
+#include <cstring>
+#include <string>
+
+template <size_t N> static void push_string(string_buf_rx<N> &b, const std::string &s)
+{
+    for (auto c : s)
+        b.push_byte_and_is_string_end(c);
+}
+
+TEST_CASE("string_buf_rx template class unit tests", "[string_buf_rx]")
+{
+    string_buf_rx<16> b;
+
+    SECTION("Peeks the string and releases it")
+    {
+        push_string(b, "MADRID\nSEVILLA\n");
+        auto v{b.peek_string()};
+        REQUIRE(v.first == "MADRID");
+        REQUIRE(v.second.empty());
+        REQUIRE(b.peek_string().first == "MADRID");
+
+        b.release();
+        REQUIRE(b.peek_string().first == "SEVILLA");
+        b.release();
+        REQUIRE(b.is_empty());
+        REQUIRE(b.peek_string().empty());
+        b.release();
+        REQUIRE(b.is_empty());
+    }
+
+    SECTION("Peeks the string wrapping around the end of the buffer")
+    {
+        push_string(b, "ABCDEFGHIJ\n");
+        b.release();
+        push_string(b, "KLMNOPQRS\n");
+
+        auto v{b.peek_string()};
+        REQUIRE(v.first == "KLMNOP");
+        REQUIRE(v.second == "QRS");
+        std::string s;
+        v.copy_to(s);
+        REQUIRE(s == "KLMNOPQRS");
+    }
+
+    SECTION("Pops the string into a string, reusing its capacity")
+    {
+        std::string s;
+        s.reserve(32);
+        auto data{s.data()};
+
+        push_string(b, "ABCDEFGHIJ\n");
+        REQUIRE(b.pop_string_into(s));
+        push_string(b, "KLMNOPQRS\n");
+        REQUIRE(b.pop_string_into(s));
+        REQUIRE(s == "KLMNOPQRS");
+        REQUIRE(s.data() == data);
+
+        REQUIRE_FALSE(b.pop_string_into(s));
+        REQUIRE(s == "KLMNOPQRS");
+    }
+
+    SECTION("Pops the string into a buffer, truncating it")
+    {
+        char buf[8];
+        push_string(b, "ABCDEFGHIJ\n");
+        b.release();
+        push_string(b, "KLMNOPQRS\nTUV\n");
+
+        REQUIRE(b.pop_into(buf, sizeof(buf)) == 9);
+        REQUIRE(std::strcmp(buf, "KLMNOPQ") == 0);
+        REQUIRE(b.pop_into(buf, sizeof(buf)) == 3);
+        REQUIRE(std::strcmp(buf, "TUV") == 0);
+        REQUIRE(b.pop_into(buf, sizeof(buf)) == 0);
+        REQUIRE(std::strcmp(buf, "TUV") == 0);
+    }
+}
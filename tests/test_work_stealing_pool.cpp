@@ -0,0 +1,59 @@
+/**
+ * @file	test_work_stealing_pool.cpp
+ * @brief	Tests the work_stealing_pool class.
+ * @author	Kacper Kowalski - kacper.s.kowalski@gmail.com
+ */
+#include "ext_deps/catch/catch.hpp"
+
+#include "work_stealing_pool.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+TEST_CASE("work_stealing_pool class unit tests", "[work_stealing_pool]")
+{
+    SECTION("Runs all the posted tasks before it is destroyed")
+    {
+        std::atomic<unsigned> count{0};
+        {
+            jungles::work_stealing_pool pool{4};
+            for (unsigned i = 0; i < 10000; ++i)
+                pool.post([&]() { ++count; });
+        }
+        REQUIRE(count == 10000);
+    }
+
+    SECTION("Runs the tasks posted by the tasks")
+    {
+        std::atomic<unsigned> count{0};
+        {
+            jungles::work_stealing_pool pool{3};
+            for (unsigned i = 0; i < 100; ++i)
+                pool.post([&]() {
+                    for (unsigned j = 0; j < 100; ++j)
+                        pool.post([&]() { ++count; });
+                });
+        }
+        REQUIRE(count == 10000);
+    }
+
+    SECTION("Idle threads steal the tasks queued behind a long task")
+    {
+        std::atomic<bool> is_long_task_done{false};
+        std::atomic<unsigned> count{0};
+        {
+            jungles::work_stealing_pool pool{2};
+            pool.post([&]() {
+                // Queues the tasks on the own queue of the thread and blocks until all of them are run.
+                for (unsigned i = 0; i < 10; ++i)
+                    pool.post([&]() { ++count; });
+                while (count != 10)
+                    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                is_long_task_done = true;
+            });
+        }
+        REQUIRE(is_long_task_done);
+        REQUIRE(count == 10);
+    }
+}